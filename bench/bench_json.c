@@ -0,0 +1,582 @@
+// 基准测试：在确定性的合成语料上测量解析、释放和构建的吞吐量。
+// 每个用例在单独的子进程中运行，峰值内存只包含该用例本身；
+// 分配次数由链接时包装的malloc/calloc/realloc/aligned_alloc统计（见Makefile的bench目标）。
+// 结果按制表符分隔输出，指定基线文件时附加与基线的耗时对比
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "json_builder.h"
+#include "json_ndjson.h"
+#include "json_parser.h"
+
+#define BENCH_DEFAULT_SIZE (2 * 1024 * 1024)
+#define BENCH_DEFAULT_TIME 0.3
+#define BENCH_MIN_ITERATIONS 3
+#define BENCH_BUILDER_MEMBERS 4096     // 构建用例每个文档的成员数
+#define BENCH_MAX_CORPORA 32
+#define BENCH_MAX_BASELINE 256
+
+// ---------- 分配计数 ----------
+
+static size_t allocations;
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_aligned_alloc(size_t alignment, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+void* __wrap_aligned_alloc(size_t alignment, size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    return __real_aligned_alloc(alignment, size);
+}
+
+static size_t allocation_count(void) {
+    return __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+}
+
+// ---------- 语料 ----------
+
+typedef enum {
+    CORPUS_JSON,
+    CORPUS_NDJSON,
+    CORPUS_BUILDER      // 没有输入，测量构建接口
+} CorpusKind;
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t capacity;
+} Corpus;
+
+typedef struct {
+    const char* name;
+    CorpusKind kind;
+    void (*generate)(Corpus* corpus, size_t size);
+    const char* path;   // -f指定的文件
+} CorpusSpec;
+
+// xorshift64*，每个语料使用固定的种子，保证每次生成的内容相同
+static uint64_t rng_state;
+
+static void rng_seed(uint64_t seed) {
+    rng_state = seed ? seed : 1;
+}
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static size_t rng_below(size_t n) {
+    return (size_t)(rng_next() % n);
+}
+
+static void corpus_reserve(Corpus* corpus, size_t additional) {
+    if (corpus->len + additional + 1 <= corpus->capacity) return;
+    size_t capacity = corpus->capacity ? corpus->capacity * 2 : 4096;
+    while (capacity < corpus->len + additional + 1) capacity *= 2;
+    corpus->data = (char*)realloc(corpus->data, capacity);
+    if (!corpus->data) {
+        fprintf(stderr, "内存不足\n");
+        exit(1);
+    }
+    corpus->capacity = capacity;
+}
+
+static void corpus_append(Corpus* corpus, const char* str, size_t len) {
+    corpus_reserve(corpus, len);
+    memcpy(corpus->data + corpus->len, str, len);
+    corpus->len += len;
+    corpus->data[corpus->len] = '\0';
+}
+
+static void corpus_printf(Corpus* corpus, const char* format, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    corpus_append(corpus, buffer, (size_t)n);
+}
+
+// 去掉最后一个逗号后追加结束符
+static void corpus_close(Corpus* corpus, const char* close) {
+    if (corpus->len > 0 && corpus->data[corpus->len - 1] == ',') corpus->len--;
+    corpus_append(corpus, close, strlen(close));
+}
+
+// 数字为主：各种宽度的整数、17位有效数字的小数、短小数和指数
+static void generate_numeric(Corpus* corpus, size_t size) {
+    rng_seed(1);
+    corpus_append(corpus, "[", 1);
+    while (corpus->len < size) {
+        corpus_printf(corpus, "[%d,%lld,%.17g,%.2f,%.6e,%u],",
+                      (int)rng_below(1000) - 500,
+                      (long long)(rng_next() >> 1) * (rng_below(2) ? 1 : -1),
+                      (double)rng_next() / (double)UINT64_MAX,
+                      (double)rng_below(1000000) / 100.0,
+                      ((double)rng_below(1000000) + 1.0) * 1e-12,
+                      (unsigned)rng_below(100));
+    }
+    corpus_close(corpus, "]");
+}
+
+// 字符串为主：长短不一，部分含转义和多字节UTF-8
+static void generate_strings(Corpus* corpus, size_t size) {
+    static const char* const pieces[] = {
+        "lorem", "ipsum", "dolor", "sit", "amet", "数据", "结构", "\\n", "\\\"quoted\\\"", "\\\\", "\\u00e9", "\\t"
+    };
+    rng_seed(2);
+    corpus_append(corpus, "[", 1);
+    while (corpus->len < size) {
+        size_t words = rng_below(8) == 0 ? 40 + rng_below(200) : 1 + rng_below(12);
+        corpus_append(corpus, "\"", 1);
+        for (size_t i = 0; i < words; i++) {
+            // 大多数字符串不含转义，走无转义的快速路径
+            size_t piece = rng_below(4) == 0 ? rng_below(12) : rng_below(7);
+            if (i > 0) corpus_append(corpus, " ", 1);
+            corpus_append(corpus, pieces[piece], strlen(pieces[piece]));
+        }
+        corpus_append(corpus, "\",", 2);
+    }
+    corpus_close(corpus, "]");
+}
+
+// 深度嵌套：每个元素是32层交替嵌套的对象和数组
+static void generate_nested(Corpus* corpus, size_t size) {
+    rng_seed(3);
+    corpus_append(corpus, "[", 1);
+    while (corpus->len < size) {
+        int depth = 32;
+        for (int d = 0; d < depth; d++) {
+            if (d % 2 == 0) corpus_printf(corpus, "{\"n%d\":%d,\"c\":", d, (int)rng_below(100));
+            else corpus_append(corpus, "[true,", 6);
+        }
+        corpus_printf(corpus, "\"leaf%d\"", (int)rng_below(1000));
+        for (int d = depth - 1; d >= 0; d--) corpus_append(corpus, d % 2 == 0 ? "}" : "]", 1);
+        corpus_append(corpus, ",", 1);
+    }
+    corpus_close(corpus, "]");
+}
+
+// 宽对象：每个对象512个成员，解析时会建立键的哈希索引
+static void generate_wide(Corpus* corpus, size_t size) {
+    rng_seed(4);
+    corpus_append(corpus, "[", 1);
+    while (corpus->len < size) {
+        corpus_append(corpus, "{", 1);
+        for (int i = 0; i < 512; i++) {
+            switch (rng_below(3)) {
+                case 0: corpus_printf(corpus, "\"field_%03d\":%d,", i, (int)rng_below(100000)); break;
+                case 1: corpus_printf(corpus, "\"field_%03d\":\"v%d\",", i, (int)rng_below(1000)); break;
+                default: corpus_printf(corpus, "\"field_%03d\":%s,", i, rng_below(2) ? "true" : "null"); break;
+            }
+        }
+        corpus_close(corpus, "},");
+    }
+    corpus_close(corpus, "]");
+}
+
+// NDJSON：每行一条日志记录
+static void generate_ndjson(Corpus* corpus, size_t size) {
+    static const char* const levels[] = {"debug", "info", "warn", "error"};
+    rng_seed(5);
+    uint64_t ts = 1700000000000ULL;
+    while (corpus->len < size) {
+        ts += rng_below(1000);
+        corpus_printf(corpus, "{\"ts\":%llu,\"level\":\"%s\",\"msg\":\"request %d handled\",",
+                      (unsigned long long)ts, levels[rng_below(4)], (int)rng_below(1000000));
+        corpus_printf(corpus, "\"user\":{\"id\":%d,\"name\":\"user%d\"},\"tags\":[\"api\",\"v%d\"],\"latency\":%.3f}\n",
+                      (int)rng_below(100000), (int)rng_below(100000), (int)rng_below(4),
+                      (double)rng_below(100000) / 1000.0);
+    }
+}
+
+static void load_file(Corpus* corpus, const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "无法打开文件 %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) corpus_append(corpus, buffer, n);
+    fclose(file);
+}
+
+// ---------- 计时 ----------
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// 一次迭代：只计入被测操作的耗时和分配次数，准备和清理不计入
+typedef struct {
+    double ns;
+    size_t allocations;
+    size_t bytes;       // 处理（解析或输出）的字节数
+    size_t ops;         // 被测操作的调用次数
+} Sample;
+
+typedef struct {
+    const char* op;
+    Sample (*run)(const Corpus* corpus);
+} BenchOp;
+
+#define MEASURE_BEGIN() size_t alloc_start = allocation_count(); double time_start = now_ns()
+#define MEASURE_END(sample)                                      \
+    do {                                                         \
+        (sample).ns = now_ns() - time_start;                     \
+        (sample).allocations = allocation_count() - alloc_start; \
+    } while (0)
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        fprintf(stderr, "%s失败: %s\n", what, json_get_error());
+        exit(1);
+    }
+}
+
+static Sample run_parse(const Corpus* corpus) {
+    Sample sample = {0, 0, corpus->len, 1};
+    MEASURE_BEGIN();
+    JsonValue* value = json_parse_n(corpus->data, corpus->len);
+    MEASURE_END(sample);
+    check(value != NULL, "json_parse_n");
+    json_value_free(value);
+    return sample;
+}
+
+static Sample run_free(const Corpus* corpus) {
+    Sample sample = {0, 0, corpus->len, 1};
+    JsonValue* value = json_parse_n(corpus->data, corpus->len);
+    check(value != NULL, "json_parse_n");
+    MEASURE_BEGIN();
+    json_value_free(value);
+    MEASURE_END(sample);
+    return sample;
+}
+
+static Sample run_document(const Corpus* corpus) {
+    Sample sample = {0, 0, corpus->len, 1};
+    MEASURE_BEGIN();
+    JsonDocument* doc = json_parse_into_n(NULL, corpus->data, corpus->len);
+    MEASURE_END(sample);
+    check(doc != NULL, "json_parse_into_n");
+    json_document_free(doc);
+    return sample;
+}
+
+static Sample run_ndjson(const Corpus* corpus) {
+    Sample sample = {0, 0, corpus->len, 1};
+    MEASURE_BEGIN();
+    JsonNdjsonBatch* batch = json_parse_ndjson(corpus->data, corpus->len, 1);
+    MEASURE_END(sample);
+    check(batch != NULL && batch->error_count == 0, "json_parse_ndjson");
+    json_ndjson_batch_free(batch);
+    return sample;
+}
+
+static Sample run_ndjson_free(const Corpus* corpus) {
+    Sample sample = {0, 0, corpus->len, 1};
+    JsonNdjsonBatch* batch = json_parse_ndjson(corpus->data, corpus->len, 1);
+    check(batch != NULL, "json_parse_ndjson");
+    MEASURE_BEGIN();
+    json_ndjson_batch_free(batch);
+    MEASURE_END(sample);
+    return sample;
+}
+
+// 构建用例的输入：键、字符串和数字预先生成，不计入耗时
+static char builder_keys[BENCH_BUILDER_MEMBERS][16];
+static char builder_strings[BENCH_BUILDER_MEMBERS][48];
+static double builder_doubles[BENCH_BUILDER_MEMBERS];
+static int64_t builder_int64s[BENCH_BUILDER_MEMBERS];
+static JsonValue* builder_value;
+
+static void builder_prepare(void) {
+    rng_seed(6);
+    for (size_t i = 0; i < BENCH_BUILDER_MEMBERS; i++) {
+        snprintf(builder_keys[i], sizeof(builder_keys[i]), "key_%zu", i);
+        snprintf(builder_strings[i], sizeof(builder_strings[i]), rng_below(8) ? "value %d" : "line\n\"%d\"\t",
+                 (int)rng_below(1000000));
+        builder_doubles[i] = (double)rng_next() / (double)UINT64_MAX * 1e6;
+        builder_int64s[i] = (int64_t)rng_next();
+    }
+    const char* json = "{\"id\":123,\"name\":\"item\",\"tags\":[\"x\",\"y\"],\"score\":1.5,\"ok\":true}";
+    builder_value = json_parse(json);
+    check(builder_value != NULL, "json_parse");
+}
+
+// 每个文档新建一个构建器，写入BENCH_BUILDER_MEMBERS个成员，包含缓冲区扩容
+#define BUILDER_RUN(name, add)                                                    \
+    static Sample name(const Corpus* corpus) {                                    \
+        (void)corpus;                                                             \
+        Sample sample = {0, 0, 0, BENCH_BUILDER_MEMBERS};                         \
+        MEASURE_BEGIN();                                                          \
+        JsonBuilder* builder = json_builder_create(0);                            \
+        bool ok = builder && json_builder_start_object(builder);                  \
+        for (size_t i = 0; ok && i < BENCH_BUILDER_MEMBERS; i++) ok = (add);      \
+        ok = ok && json_builder_end_object(builder);                              \
+        MEASURE_END(sample);                                                      \
+        check(ok, #name);                                                         \
+        sample.bytes = builder->length;                                           \
+        json_builder_free(builder);                                               \
+        return sample;                                                            \
+    }
+
+BUILDER_RUN(run_add_string, json_builder_add_string(builder, builder_keys[i], builder_strings[i]))
+BUILDER_RUN(run_add_number, json_builder_add_number(builder, builder_keys[i], builder_doubles[i]))
+BUILDER_RUN(run_add_int64, json_builder_add_int64(builder, builder_keys[i], builder_int64s[i]))
+BUILDER_RUN(run_add_uint64, json_builder_add_uint64(builder, builder_keys[i], (uint64_t)builder_int64s[i]))
+BUILDER_RUN(run_add_bool, json_builder_add_bool(builder, builder_keys[i], i % 2 == 0))
+BUILDER_RUN(run_add_null, json_builder_add_null(builder, builder_keys[i]))
+BUILDER_RUN(run_add_value, json_builder_add_value(builder, builder_keys[i], builder_value, JSON_SERIALIZE_COMPACT))
+
+static const BenchOp json_ops[] = {
+    {"parse", run_parse},
+    {"free", run_free},
+    {"document", run_document},
+    {NULL, NULL}
+};
+
+static const BenchOp ndjson_ops[] = {
+    {"parse_ndjson", run_ndjson},
+    {"free", run_ndjson_free},
+    {NULL, NULL}
+};
+
+static const BenchOp builder_ops[] = {
+    {"add_string", run_add_string},
+    {"add_number", run_add_number},
+    {"add_int64", run_add_int64},
+    {"add_uint64", run_add_uint64},
+    {"add_bool", run_add_bool},
+    {"add_null", run_add_null},
+    {"add_value", run_add_value},
+    {NULL, NULL}
+};
+
+// ---------- 基线 ----------
+
+typedef struct {
+    char name[128];     // "语料/操作"
+    double ns_per_op;
+} BaselineRow;
+
+static BaselineRow baseline[BENCH_MAX_BASELINE];
+static size_t baseline_count;
+
+// 读取之前的输出，跳过表头和注释
+static void load_baseline(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "无法打开基线文件 %s: %s\n", path, strerror(errno));
+        exit(1);
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), file) && baseline_count < BENCH_MAX_BASELINE) {
+        char corpus[64], op[64];
+        double ns;
+        if (line[0] == '#' || strncmp(line, "corpus\t", 7) == 0) continue;
+        if (sscanf(line, "%63s %63s %*s %*s %lf", corpus, op, &ns) != 3) continue;
+        snprintf(baseline[baseline_count].name, sizeof(baseline[baseline_count].name), "%s/%s", corpus, op);
+        baseline[baseline_count].ns_per_op = ns;
+        baseline_count++;
+    }
+    fclose(file);
+}
+
+static const BaselineRow* find_baseline(const char* corpus, const char* op) {
+    char name[128];
+    snprintf(name, sizeof(name), "%s/%s", corpus, op);
+    for (size_t i = 0; i < baseline_count; i++) {
+        if (strcmp(baseline[i].name, name) == 0) return &baseline[i];
+    }
+    return NULL;
+}
+
+// ---------- 运行 ----------
+
+typedef struct {
+    size_t size;
+    double min_time;
+    const char* filter;
+} BenchConfig;
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return x < y ? -1 : x > y;
+}
+
+// 在子进程中运行一个用例：反复运行直到累计耗时达到min_time，按每次迭代耗时的中位数报告
+static void run_case(const CorpusSpec* spec, const BenchOp* op, const BenchConfig* config) {
+    Corpus corpus = {NULL, 0, 0};
+    if (spec->path) load_file(&corpus, spec->path);
+    else if (spec->generate) spec->generate(&corpus, config->size);
+    else builder_prepare();
+
+    size_t capacity = 64, count = 0;
+    double* times = (double*)malloc(sizeof(double) * capacity);
+    double total = 0;
+    Sample first = op->run(&corpus);   // 预热，同时记录分配次数和字节数
+    while (count < BENCH_MIN_ITERATIONS || total < config->min_time * 1e9) {
+        Sample sample = op->run(&corpus);
+        if (count == capacity) {
+            capacity *= 2;
+            times = (double*)realloc(times, sizeof(double) * capacity);
+        }
+        times[count++] = sample.ns;
+        total += sample.ns;
+    }
+    qsort(times, count, sizeof(double), compare_double);
+    double median = times[count / 2];
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%s\t%s\t%zu\t%zu\t%.1f\t%.1f\t%zu\t%ld", spec->name, op->op, first.bytes, count,
+           median / (double)first.ops, (double)first.bytes / median * 1e9 / (1024.0 * 1024.0),
+           first.allocations, usage.ru_maxrss);
+    const BaselineRow* base = find_baseline(spec->name, op->op);
+    if (base) {
+        double ns = median / (double)first.ops;
+        printf("\t%.1f\t%+.1f%%", base->ns_per_op, (ns - base->ns_per_op) / base->ns_per_op * 100.0);
+    }
+    printf("\n");
+    fflush(stdout);
+    free(times);
+    free(corpus.data);
+}
+
+static void write_corpora(const CorpusSpec* specs, size_t count, const char* dir, size_t size) {
+    for (size_t i = 0; i < count; i++) {
+        if (!specs[i].generate) continue;
+        Corpus corpus = {NULL, 0, 0};
+        specs[i].generate(&corpus, size);
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/%s.%s", dir, specs[i].name,
+                 specs[i].kind == CORPUS_NDJSON ? "ndjson" : "json");
+        FILE* file = fopen(path, "wb");
+        if (!file || fwrite(corpus.data, 1, corpus.len, file) != corpus.len) {
+            fprintf(stderr, "无法写入 %s\n", path);
+            exit(1);
+        }
+        fclose(file);
+        printf("%s\t%zu\n", path, corpus.len);
+        free(corpus.data);
+    }
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "用法: %s [-s 字节数] [-t 秒] [-f 文件]... [-c 过滤] [-b 基线文件] [-w 目录]\n"
+            "  -s  每个合成语料的大小，默认%d\n"
+            "  -t  每个用例的最短运行时间，默认%.1f秒\n"
+            "  -f  追加一个语料文件，.ndjson/.jsonl按NDJSON处理\n"
+            "  -c  只运行名称（语料/操作）包含该字符串的用例\n"
+            "  -b  与之前保存的输出对比每次操作的耗时\n"
+            "  -w  把合成语料写入目录后退出\n",
+            program, BENCH_DEFAULT_SIZE, BENCH_DEFAULT_TIME);
+}
+
+static bool has_suffix(const char* str, const char* suffix) {
+    size_t n = strlen(str), m = strlen(suffix);
+    return n >= m && strcmp(str + n - m, suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    CorpusSpec specs[BENCH_MAX_CORPORA] = {
+        {"numeric", CORPUS_JSON, generate_numeric, NULL},
+        {"strings", CORPUS_JSON, generate_strings, NULL},
+        {"nested", CORPUS_JSON, generate_nested, NULL},
+        {"wide", CORPUS_JSON, generate_wide, NULL},
+        {"ndjson", CORPUS_NDJSON, generate_ndjson, NULL},
+        {"builder", CORPUS_BUILDER, NULL, NULL},
+    };
+    size_t spec_count = 6;
+    BenchConfig config = {BENCH_DEFAULT_SIZE, BENCH_DEFAULT_TIME, NULL};
+    const char* corpus_dir = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:f:c:b:w:h")) != -1) {
+        switch (opt) {
+            case 's': config.size = (size_t)strtoull(optarg, NULL, 10); break;
+            case 't': config.min_time = strtod(optarg, NULL); break;
+            case 'c': config.filter = optarg; break;
+            case 'b': load_baseline(optarg); break;
+            case 'w': corpus_dir = optarg; break;
+            case 'f': {
+                if (spec_count == BENCH_MAX_CORPORA) break;
+                const char* base = strrchr(optarg, '/');
+                CorpusSpec* spec = &specs[spec_count++];
+                spec->name = base ? base + 1 : optarg;
+                spec->kind = has_suffix(optarg, ".ndjson") || has_suffix(optarg, ".jsonl") ? CORPUS_NDJSON : CORPUS_JSON;
+                spec->generate = NULL;
+                spec->path = optarg;
+                break;
+            }
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (corpus_dir) {
+        write_corpora(specs, spec_count, corpus_dir, config.size);
+        return 0;
+    }
+
+    printf("# lightjson bench: size=%zu min_time=%.2fs, ns_per_op为中位数，allocs为每个文档的分配次数\n",
+           config.size, config.min_time);
+    printf("corpus\top\tbytes\titers\tns_per_op\tmb_per_s\tallocs_per_doc\tpeak_rss_kb%s\n",
+           baseline_count ? "\tbase_ns_per_op\tdelta" : "");
+    fflush(stdout);
+
+    int failures = 0;
+    for (size_t i = 0; i < spec_count; i++) {
+        const BenchOp* ops = specs[i].kind == CORPUS_JSON ? json_ops
+                           : specs[i].kind == CORPUS_NDJSON ? ndjson_ops : builder_ops;
+        for (const BenchOp* op = ops; op->op; op++) {
+            char name[128];
+            snprintf(name, sizeof(name), "%s/%s", specs[i].name, op->op);
+            if (config.filter && !strstr(name, config.filter)) continue;
+
+            pid_t pid = fork();
+            if (pid == 0) {
+                run_case(&specs[i], op, &config);
+                _exit(0);
+            }
+            int status = 0;
+            if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                fprintf(stderr, "用例 %s 失败\n", name);
+                failures++;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
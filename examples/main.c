@@ -57,6 +57,12 @@ int main() {
                 case JSON_NUMBER:
                     printf("值(数字): %f\n", v->value.number);
                     break;
+                case JSON_INT64:
+                    printf("值(整数): %lld\n", (long long)v->value.int64);
+                    break;
+                case JSON_UINT64:
+                    printf("值(整数): %llu\n", (unsigned long long)v->value.uint64);
+                    break;
                 case JSON_BOOL:
                     printf("值(布尔): %s\n", v->value.boolean ? "true" : "false");
                     break;
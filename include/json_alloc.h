@@ -0,0 +1,46 @@
+#ifndef JSON_ALLOC_H
+#define JSON_ALLOC_H
+
+#include <stddef.h>
+
+// 内存分配器：库的所有堆内存都经由分配器申请和释放。
+// realloc的ptr为NULL时等同于malloc；free的ptr可以为NULL。ctx原样传给各回调
+typedef struct JsonAllocator {
+    void* (*malloc)(void* ctx, size_t size);
+    void* (*realloc)(void* ctx, void* ptr, size_t size);
+    void (*free)(void* ctx, void* ptr);
+    void* ctx;
+} JsonAllocator;
+
+// 设置全局分配器（复制一份），NULL恢复为标准库的malloc/realloc/free。
+// 未指定分配器的对象都使用全局分配器，申请和释放时各自读取，因此应在启动时设置一次，
+// 切换前用旧分配器分配的对象需先释放
+void json_set_allocator(const JsonAllocator* allocator);
+const JsonAllocator* json_get_allocator(void);
+
+// 经由分配器分配和释放，allocator为NULL时使用全局分配器；
+// json_value_to_string等返回给调用者的缓冲区用json_free(NULL, ptr)释放
+void* json_malloc(const JsonAllocator* allocator, size_t size);
+void* json_calloc(const JsonAllocator* allocator, size_t count, size_t size);
+void* json_realloc(const JsonAllocator* allocator, void* ptr, size_t size);
+void json_free(const JsonAllocator* allocator, void* ptr);
+
+// 分配统计：计数分配器把请求转发给parent，同时记录分配次数、字节数和峰值占用。
+// 每块内存前附加一个记录大小的头部；计数使用原子操作，可以被多个线程共用
+typedef struct {
+    JsonAllocator parent;   // 实际分配内存的分配器
+    size_t allocations;     // malloc和realloc的次数
+    size_t frees;           // 释放次数
+    size_t bytes;           // 累计申请的字节数（realloc计新的大小）
+    size_t current;         // 当前未释放的字节数
+    size_t peak;            // current的最大值
+} JsonAllocStats;
+
+// 初始化统计，返回计数分配器；parent为NULL时转发给当前的全局分配器。
+// 返回的分配器引用stats，stats需在所有经由它分配的内存释放之后才能销毁
+JsonAllocator json_alloc_stats_init(JsonAllocStats* stats, const JsonAllocator* parent);
+
+// 清零次数和字节数，峰值重置为当前占用；每次解析前调用即得到单次解析的统计
+void json_alloc_stats_reset(JsonAllocStats* stats);
+
+#endif // JSON_ALLOC_H
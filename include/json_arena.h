@@ -0,0 +1,44 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <stddef.h>
+#include "json_alloc.h"
+
+// 默认内存块大小
+#define JSON_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// 内存块（数据紧随其后）
+typedef struct JsonArenaBlock {
+    struct JsonArenaBlock* next;
+    size_t size;
+    size_t used;
+} JsonArenaBlock;
+
+// 线性（bump-pointer）内存池，所有分配随内存池一次性释放
+typedef struct JsonArena {
+    JsonArenaBlock* head;
+    size_t block_size;
+    void* last;
+    JsonArenaBlock* spare;  // json_arena_rewind保留的空闲内存块，分配新块时优先使用
+    const JsonAllocator* allocator;  // 内存池本身和内存块的分配器，NULL时使用全局分配器
+} JsonArena;
+
+// 创建和销毁
+JsonArena* json_arena_create(size_t block_size);
+void json_arena_free(JsonArena* arena);
+void json_arena_reset(JsonArena* arena);
+
+// 使用指定的分配器创建内存池，allocator需在内存池释放前保持有效
+JsonArena* json_arena_create_with(size_t block_size, const JsonAllocator* allocator);
+// 清空内存池但保留全部内存块，之后的分配依次复用这些内存块；
+// 每次用量相近的重复解析在预热后不再调用malloc
+void json_arena_rewind(JsonArena* arena);
+
+// 把src的所有内存块移入dst，之后随dst一起释放；src变为空，可以继续使用。两者的分配器必须相同
+void json_arena_merge(JsonArena* dst, JsonArena* src);
+
+// 分配操作
+void* json_arena_alloc(JsonArena* arena, size_t size);
+void* json_arena_realloc(JsonArena* arena, void* ptr, size_t old_size, size_t new_size);
+
+#endif // JSON_ARENA_H
@@ -2,22 +2,71 @@
 #define JSON_BUILDER_H
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "json_alloc.h"
+#include "json_parser.h"
+
+// 输出到目标时的默认缓冲区大小和最小缓冲区大小
+#define JSON_BUILDER_SINK_BUFFER_SIZE 65536
+#define JSON_BUILDER_SINK_MIN_BUFFER 64
+
+// 构建选项
+typedef enum {
+    JSON_BUILDER_DEFAULT = 0,
+    JSON_BUILDER_ASCII = 1 << 0     // 非ASCII字符输出为\uXXXX转义，无效的UTF-8字节输出为\uFFFD
+} JsonBuilderFlags;
+
+// 序列化选项
+typedef enum {
+    JSON_SERIALIZE_COMPACT = 0,
+    JSON_SERIALIZE_PRETTY = 1 << 0,     // 每个成员和元素单独一行，缩进JSON_SERIALIZE_INDENT个空格
+    JSON_SERIALIZE_ASCII = 1 << 1       // 同JSON_BUILDER_ASCII
+} JsonSerializeFlags;
+
+#define JSON_SERIALIZE_INDENT 2
+
+// 输出回调：写出data[0, len)，失败时返回false
+typedef bool (*JsonBuilderWriteFn)(void* ctx, const char* data, size_t len);
 
 typedef struct {
     char* buffer;
     size_t capacity;
     size_t length;
+    unsigned flags;     // JsonBuilderFlags组合
+
+    // 输出目标：write非空时写入回调，fd非负时写入文件描述符，都没有时在内存中构建
+    JsonBuilderWriteFn write;
+    void* write_ctx;
+    int fd;
+    bool failed;        // 写入输出目标失败后，之后的刷新都返回false
+    const JsonAllocator* allocator;  // 构建器和缓冲区的分配器，NULL时使用全局分配器
 } JsonBuilder;
 
 // 创建和销毁
 JsonBuilder* json_builder_create(size_t initial_capacity);
 void json_builder_free(JsonBuilder* builder);
+void json_builder_set_flags(JsonBuilder* builder, unsigned flags);
+
+// 使用指定的分配器创建构建器，缓冲区扩容也经由该分配器；allocator需在构建器释放前保持有效
+JsonBuilder* json_builder_create_with(size_t initial_capacity, const JsonAllocator* allocator);
+
+// 输出到目标：使用固定大小的缓冲区（buffer_size为0时使用默认大小），写满时刷新到目标，
+// 较长的字符串不经过缓冲区直接写出（文件描述符使用writev合并写入）；
+// 结束前需调用json_builder_flush，json_builder_free不会刷新
+JsonBuilder* json_builder_create_fd(int fd, size_t buffer_size);
+JsonBuilder* json_builder_create_file(FILE* file, size_t buffer_size);
+JsonBuilder* json_builder_create_callback(JsonBuilderWriteFn write, void* ctx, size_t buffer_size);
+
+// 写出缓冲区内容；末尾的逗号保留到下一次写入，以便结束对象或数组时撤销。内存模式下不做任何事
+bool json_builder_flush(JsonBuilder* builder);
 
 // 基本操作
 bool json_builder_ensure_capacity(JsonBuilder* builder, size_t additional);
 bool json_builder_append(JsonBuilder* builder, const char* str);
-const char* json_builder_get_string(JsonBuilder* builder);
+bool json_builder_append_n(JsonBuilder* builder, const char* str, size_t len);
+const char* json_builder_get_string(JsonBuilder* builder);     // 输出到目标时返回NULL
 
 // JSON结构操作
 bool json_builder_start_object(JsonBuilder* builder);
@@ -28,9 +77,36 @@ bool json_builder_end_array(JsonBuilder* builder);
 // 添加各种类型的键值对
 bool json_builder_add_string(JsonBuilder* builder, const char* key, const char* value);
 bool json_builder_add_number(JsonBuilder* builder, const char* key, double value);
+bool json_builder_add_int64(JsonBuilder* builder, const char* key, int64_t value);
+bool json_builder_add_uint64(JsonBuilder* builder, const char* key, uint64_t value);
 bool json_builder_add_bool(JsonBuilder* builder, const char* key, bool value);
 bool json_builder_add_null(JsonBuilder* builder, const char* key);
 
+// 带长度的版本：无需strlen，键和值不要求以'\0'结尾，一次预留空间后直接写入缓冲区；
+// 键和字符串值中的'"'、'\\'和控制字符都会被转义
+bool json_builder_add_string_n(JsonBuilder* builder, const char* key, size_t key_len,
+                               const char* value, size_t value_len);
+bool json_builder_add_number_n(JsonBuilder* builder, const char* key, size_t key_len, double value);
+bool json_builder_add_int64_n(JsonBuilder* builder, const char* key, size_t key_len, int64_t value);
+bool json_builder_add_uint64_n(JsonBuilder* builder, const char* key, size_t key_len, uint64_t value);
+bool json_builder_add_bool_n(JsonBuilder* builder, const char* key, size_t key_len, bool value);
+bool json_builder_add_null_n(JsonBuilder* builder, const char* key, size_t key_len);
+
+// 序列化JsonValue树：先计算输出的准确字节数一次预留空间，再遍历一次写入；
+// 输出到目标时按缓冲区分段写出。json_value_serialize与json_builder_append一样不附加逗号，
+// json_builder_add_value与其他add_*一样写入"key":value,
+bool json_value_serialize(const JsonValue* value, JsonBuilder* builder, unsigned flags);
+bool json_builder_add_value(JsonBuilder* builder, const char* key, const JsonValue* value, unsigned flags);
+bool json_builder_add_value_n(JsonBuilder* builder, const char* key, size_t key_len,
+                              const JsonValue* value, unsigned flags);
+
+// 序列化后的字节数（不含'\0'）
+size_t json_value_serialized_length(const JsonValue* value, unsigned flags);
+
+// 序列化为新分配的字符串（只分配一次），由调用者用json_free(NULL, ptr)释放（未设置全局分配器时也可以直接free）；
+// length非空时返回字节数
+char* json_value_to_string(const JsonValue* value, unsigned flags, size_t* length);
+
 // 控制台编码设置
 void set_console_utf8();
 
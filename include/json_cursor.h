@@ -0,0 +1,54 @@
+#ifndef JSON_CURSOR_H
+#define JSON_CURSOR_H
+
+#include "json_parser.h"
+
+// 按需解析：游标指向原始输入中某个值的第一个字符，值只在被访问时解码；
+// 查找时未访问的子树用引号感知的括号匹配整段跳过，不分配内存也不反转义。
+// 只有被访问的部分会被校验，输入在解析器释放前必须保持有效
+
+// 游标；parser为NULL表示值不存在（键或下标未找到，或输入有误，后者会设置错误消息）
+typedef struct {
+    JsonParser* parser;
+    size_t pos;         // 值第一个字符的位置
+} JsonCursor;
+
+// 按顺序遍历容器的成员
+typedef struct {
+    JsonParser* parser;
+    size_t pos;         // 开始括号之后，或上一个返回的值的起始位置
+    bool object;
+    bool started;       // 已返回过成员，下次先跳过上一个值
+    bool done;
+} JsonCursorIter;
+
+// 创建按需解析用的解析器，flags可包含JSON_PARSE_INT64和JSON_PARSE_VIEWS（用于json_cursor_value）；
+// 解码出的字符串和子树分配在解析器持有的内存池中，随json_parser_free释放
+JsonParser* json_parser_create_lazy(const char* json, size_t len, unsigned flags);
+
+// 根值
+JsonCursor json_cursor_root(JsonParser* parser);
+
+// 值的类型，由第一个字符判断；值不存在时返回JSON_NULL
+JsonValueType json_cursor_type(JsonCursor cursor);
+
+// 按键或下标查找，依次跳过前面的成员；键重复时返回第一个
+JsonCursor json_cursor_get(JsonCursor object, const char* key, size_t key_length);
+JsonCursor json_cursor_at(JsonCursor array, size_t index);
+
+// 遍历：对象的键通过key返回（含转义时为解码后的副本），数组元素的key为NULL
+JsonCursorIter json_cursor_iter(JsonCursor container);
+bool json_cursor_next(JsonCursorIter* iter, const char** key, size_t* key_length, JsonCursor* value);
+
+// 取值：无转义的字符串直接指向输入，不以'\0'结尾，需配合长度使用；
+// 类型不符或格式无效时返回NULL/0/false
+const char* json_cursor_get_string(JsonCursor cursor, size_t* length);
+double json_cursor_get_number(JsonCursor cursor);
+int64_t json_cursor_get_int64(JsonCursor cursor);
+uint64_t json_cursor_get_uint64(JsonCursor cursor);
+bool json_cursor_get_bool(JsonCursor cursor);
+
+// 把游标处的整个值解析为JsonValue树，分配在解析器的内存池中，不要用json_value_free释放
+JsonValue* json_cursor_value(JsonCursor cursor);
+
+#endif // JSON_CURSOR_H
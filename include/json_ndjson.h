@@ -0,0 +1,39 @@
+#ifndef JSON_NDJSON_H
+#define JSON_NDJSON_H
+
+#include "json_parser.h"
+
+// 每次从工作区间领取的记录数
+#define JSON_NDJSON_GRAIN 16
+
+// 批量解析结果：文档按输入顺序排列，所有节点位于各工作线程的内存池中
+typedef struct JsonNdjsonBatch {
+    JsonDocument** documents;   // 解析失败的记录为NULL
+    const char** errors;        // 失败记录的错误消息，成功的记录为NULL
+    JsonError* record_errors;   // 每条记录的错误码和偏移，成功的记录code为JSON_ERROR_NONE；
+                                // 偏移相对整个输入，可直接用json_error_locate(&e, json, len)定位
+    size_t count;               // 记录数（空白行不计）
+    size_t error_count;
+    JsonArena** arenas;
+    size_t arena_count;
+} JsonNdjsonBatch;
+
+// 流式迭代器：后台线程并行解析，按输入顺序逐条取出
+typedef struct JsonNdjsonIter JsonNdjsonIter;
+
+// 批量解析换行分隔的JSON记录，threads为0时使用全部在线CPU
+JsonNdjsonBatch* json_parse_ndjson(const char* json, size_t len, size_t threads);
+void json_ndjson_batch_free(JsonNdjsonBatch* batch);
+
+// 流式迭代：next在输入结束时返回false，失败的记录返回true且*doc为NULL；
+// 文档在迭代器释放前有效
+JsonNdjsonIter* json_ndjson_iter_create(const char* json, size_t len, size_t threads);
+bool json_ndjson_iter_next(JsonNdjsonIter* iter, JsonDocument** doc);
+const char* json_ndjson_iter_error(const JsonNdjsonIter* iter);
+
+// 最近取出记录的错误码和偏移（相对整个输入），成功时code为JSON_ERROR_NONE
+JsonError json_ndjson_iter_last_error(const JsonNdjsonIter* iter);
+
+void json_ndjson_iter_free(JsonNdjsonIter* iter);
+
+#endif // JSON_NDJSON_H
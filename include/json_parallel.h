@@ -0,0 +1,19 @@
+#ifndef JSON_PARALLEL_H
+#define JSON_PARALLEL_H
+
+#include "json_parser.h"
+
+// 每块的最小字节数，输入较小时使用的线程也相应减少
+#define JSON_PARALLEL_MIN_CHUNK (256 * 1024)
+
+// 每个线程平均分到的块数：块数多于线程数，先做完的线程继续领取剩余的块
+#define JSON_PARALLEL_CHUNKS_PER_THREAD 4
+
+// 并行解析顶层为数组的文档：先用SIMD扫描一遍找出数组的结束括号，同时在第一层的逗号处
+// 按字节数把数组分成若干块（字符串内的逗号和括号不参与切分），各线程严格解析块到自己的
+// 内存池，最后按输入顺序合并为一个数组，各内存池并入文档。顶层不是数组时按普通文档解析。
+// flags可包含JSON_PARSE_INT64和JSON_PARSE_VIEWS；threads为0时使用全部在线CPU；
+// 失败时返回NULL，错误为输入中第一个出错的元素的错误
+JsonDocument* json_parse_array_parallel(const char* json, size_t len, unsigned flags, size_t threads);
+
+#endif // JSON_PARALLEL_H
@@ -3,6 +3,14 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "json_arena.h"
+
+// 容器暂存栈的初始字节数，不够时倍增
+#define JSON_STACK_INITIAL_SIZE 4096
+
+// 成员数达到该值的对象在解析时建立键的哈希索引
+#define JSON_OBJECT_INDEX_MIN_SIZE 16
 
 // JSON值类型枚举
 typedef enum {
@@ -11,13 +19,68 @@ typedef enum {
     JSON_NUMBER,
     JSON_STRING,
     JSON_ARRAY,
-    JSON_OBJECT
+    JSON_OBJECT,
+    JSON_INT64,     // 仅在JSON_PARSE_INT64下产生：可用int64_t精确表示的整数
+    JSON_UINT64     // 仅在JSON_PARSE_INT64下产生：超出int64_t但不超出uint64_t的整数
 } JsonValueType;
 
+// 解析选项
+typedef enum {
+    JSON_PARSE_DEFAULT = 0,
+    JSON_PARSE_INSITU = 1 << 0,    // 字符串直接指向输入缓冲区并原地解码（缓冲区必须可写）
+    JSON_PARSE_VIEWS = 1 << 1,     // 无转义的字符串直接指向只读输入，不以'\0'结尾，需配合长度使用
+    JSON_PARSE_INT64 = 1 << 2      // 64位范围内的整数保存为JSON_INT64/JSON_UINT64，不经过double
+} JsonParseFlags;
+
+// 错误码，json_error_message给出对应的消息
+typedef enum {
+    JSON_ERROR_NONE = 0,
+    JSON_ERROR_INVALID_ARGUMENT,
+    JSON_ERROR_INVALID_FLAGS,
+    JSON_ERROR_OUT_OF_MEMORY,
+    JSON_ERROR_INVALID_VALUE,
+    JSON_ERROR_INVALID_NUMBER,
+    JSON_ERROR_INVALID_BOOL,
+    JSON_ERROR_INVALID_NULL,
+    JSON_ERROR_EXPECTED_STRING,
+    JSON_ERROR_UNTERMINATED_STRING,
+    JSON_ERROR_EXPECTED_COLON,
+    JSON_ERROR_EXPECTED_ARRAY,
+    JSON_ERROR_EXPECTED_OBJECT,
+    JSON_ERROR_EXPECTED_ARRAY_SEPARATOR,
+    JSON_ERROR_EXPECTED_OBJECT_SEPARATOR,
+    JSON_ERROR_UNTERMINATED_ARRAY,
+    JSON_ERROR_UNTERMINATED_OBJECT,
+    JSON_ERROR_TRAILING_CHARACTERS,
+    JSON_ERROR_ABORTED,
+    JSON_ERROR_NOT_PUSH_PARSER,
+    JSON_ERROR_FILE_OPEN,
+    JSON_ERROR_FILE_READ,
+    JSON_ERROR_FILE_MAP,
+    JSON_ERROR_DOCUMENT_TOO_LARGE,
+    JSON_ERROR_THREAD_CREATE,
+    JSON_ERROR_POINTER_START,
+    JSON_ERROR_POINTER_ESCAPE,
+    JSON_ERROR_FILE_WRITE,
+    JSON_ERROR_SNAPSHOT_FORMAT,
+    JSON_ERROR_INVALID_ESCAPE,
+    JSON_ERROR_COUNT
+} JsonErrorCode;
+
+// 错误信息：出错时只记录错误码和字节偏移，行号和列号在查询时才计算
+typedef struct {
+    JsonErrorCode code;
+    size_t offset;      // 出错处相对输入开头的字节偏移，与输入无关的错误为0
+    size_t line;        // 从1开始；未定位时为0
+    size_t column;      // 从1开始，按字节计；未定位时为0
+} JsonError;
+
 // 前向声明
 struct JsonValue;
 struct JsonObject;
 struct JsonArray;
+struct JsonPushState;
+struct JsonDocumentScratch;
 
 // JSON值结构体
 typedef struct JsonValue {
@@ -25,15 +88,20 @@ typedef struct JsonValue {
     union {
         bool boolean;
         double number;
+        int64_t int64;
+        uint64_t uint64;
         char* string;
         struct JsonArray* array;
         struct JsonObject* object;
     } value;
+    size_t length;      // 字符串字节数（仅JSON_STRING）
 } JsonValue;
 
 // JSON对象键值对
 typedef struct JsonKeyValue {
     char* key;
+    size_t key_length;
+    uint32_t hash;      // 键的哈希值，解析键时计算
     JsonValue* value;
 } JsonKeyValue;
 
@@ -42,6 +110,8 @@ typedef struct JsonObject {
     JsonKeyValue* pairs;
     size_t size;
     size_t capacity;
+    uint32_t* index;    // 开放寻址哈希索引，槽位存放键值对下标+1（0为空槽），小对象为NULL
+    size_t index_mask;  // 槽位数-1
 } JsonObject;
 
 // JSON数组结构体
@@ -56,14 +126,71 @@ typedef struct {
     const char* json;
     size_t pos;
     size_t len;
+    JsonArena* arena;   // 非空时所有节点和字符串都从该内存池分配
+    unsigned flags;     // JsonParseFlags组合
+    struct JsonPushState* push;  // 增量解析状态，仅json_parser_create_push创建的解析器使用
+    bool owns_arena;    // 释放解析器时一并释放arena（json_parser_create_lazy）
+    char* stack;        // 容器暂存栈，仅与arena一起使用：元素和成员先压栈，容器结束时按实际个数复制到arena
+    size_t stack_size;
+    size_t stack_capacity;
+    const JsonAllocator* allocator;  // 解析器、暂存栈和值树的分配器，NULL时使用全局分配器
+    JsonError error;    // 该解析器最近一次的错误，line和column由json_parser_get_error计算
 } JsonParser;
 
+// 增量解析的返回状态
+typedef enum {
+    JSON_FEED_NEED_MORE,   // 值尚未完整，需要继续输入
+    JSON_FEED_COMPLETE,    // 已得到完整的值
+    JSON_FEED_ERROR        // 解析出错，详见json_get_error()
+} JsonFeedStatus;
+
+// 事件回调：字符串和键不以'\0'结尾，指针只在回调期间有效；
+// 返回false时中止解析，为NULL的回调表示忽略该事件
+typedef struct JsonHandler {
+    bool (*start_object)(void* ctx);
+    bool (*end_object)(void* ctx);
+    bool (*start_array)(void* ctx);
+    bool (*end_array)(void* ctx);
+    bool (*key)(void* ctx, const char* key, size_t len);
+    bool (*string)(void* ctx, const char* str, size_t len);
+    bool (*number)(void* ctx, double value);
+    bool (*boolean)(void* ctx, bool value);
+    bool (*null)(void* ctx);
+} JsonHandler;
+
+// JSON文档：所有节点、字符串和子数组都位于同一个内存池中
+typedef struct JsonDocument {
+    JsonArena* arena;
+    JsonValue* root;
+    bool owns_arena;
+    void* mapping;      // json_parse_file映射的文件内容，释放文档时解除映射
+    size_t mapping_size;
+    struct JsonDocumentScratch* scratch;  // json_document_create创建的可复用文档保留的解析缓冲区，其他文档为NULL
+} JsonDocument;
+
 // 创建和销毁函数
 JsonParser* json_parser_create(const char* json);
+JsonParser* json_parser_create_n(const char* json, size_t len);
 void json_parser_free(JsonParser* parser);
 
+// 使用指定的分配器创建解析器，json_parse_value得到的值树需用json_value_free_with以同一分配器释放；
+// allocator需在解析器和值树释放前保持有效
+JsonParser* json_parser_create_with(const char* json, size_t len, const JsonAllocator* allocator);
+
+// 增量解析：输入可以分成任意多块依次送入，状态跨块保存
+JsonParser* json_parser_create_push(void);
+
+// 使用指定的分配器创建增量解析器，json_parser_take_value取走的值树需用json_value_free_with释放
+JsonParser* json_parser_create_push_with(const JsonAllocator* allocator);
+JsonFeedStatus json_parser_feed(JsonParser* parser, const char* chunk, size_t len);
+JsonFeedStatus json_parser_finish(JsonParser* parser);
+JsonValue* json_parser_take_value(JsonParser* parser);
+
 // 解析函数
 JsonValue* json_parse(const char* json);
+JsonValue* json_parse_n(const char* json, size_t len);
+JsonValue* json_parse_ex(const char* json, size_t len, unsigned flags);
+bool json_parse_events(const char* json, size_t len, const JsonHandler* handler, void* ctx);
 JsonValue* json_parse_value(JsonParser* parser);
 JsonObject* json_parse_object(JsonParser* parser);
 JsonArray* json_parse_array(JsonParser* parser);
@@ -72,15 +199,57 @@ double json_parse_number(JsonParser* parser);
 bool json_parse_bool(JsonParser* parser);
 void json_parse_null(JsonParser* parser);
 
+// 文档模式：arena为NULL时文档自行创建并持有内存池
+JsonDocument* json_parse_into(JsonArena* arena, const char* json);
+JsonDocument* json_parse_into_n(JsonArena* arena, const char* json, size_t len);
+JsonDocument* json_parse_into_ex(JsonArena* arena, const char* json, size_t len, unsigned flags);
+JsonDocument* json_parse_insitu(JsonArena* arena, char* json);
+JsonDocument* json_parse_insitu_n(JsonArena* arena, char* json, size_t len);
+JsonDocument* json_parse_file(const char* path, unsigned flags);
+JsonValue* json_document_root(JsonDocument* doc);
+void json_document_free(JsonDocument* doc);
+
+// 可复用文档：文档、内存池和容器暂存栈在多次解析之间保留，
+// 输入规模稳定时预热后的解析不再调用malloc/free
+JsonDocument* json_document_create(void);
+
+// 使用指定的分配器创建可复用文档，allocator需在文档释放前保持有效
+JsonDocument* json_document_create_with(const JsonAllocator* allocator);
+
+// 解析到可复用文档，先丢弃上一次的结果；成功时返回根节点，失败时返回NULL，文档可继续使用。
+// flags与json_parse_into_ex相同，另外接受JSON_PARSE_INSITU（此时json必须可写）
+JsonValue* json_document_parse(JsonDocument* doc, const char* json, size_t len, unsigned flags);
+
+// 丢弃可复用文档的解析结果，保留内存以供下一次解析；对其他文档无效
+void json_document_reset(JsonDocument* doc);
+
 // 值操作函数
 void json_value_free(JsonValue* value);
+void json_value_free_with(JsonValue* value, const JsonAllocator* allocator);
 const char* json_value_get_string(JsonValue* value);
+size_t json_value_get_string_length(JsonValue* value);
 double json_value_get_number(JsonValue* value);
+int64_t json_value_get_int64(JsonValue* value);
+uint64_t json_value_get_uint64(JsonValue* value);
+bool json_value_is_number(JsonValue* value);
 bool json_value_get_bool(JsonValue* value);
 JsonObject* json_value_get_object(JsonValue* value);
 JsonArray* json_value_get_array(JsonValue* value);
 
-// 错误处理
+// 按键查找对象成员，键重复时返回第一个；不存在时返回NULL
+JsonValue* json_object_get(const JsonObject* object, const char* key, size_t key_length);
+
+// 错误处理：每个线程各自保存最近一次的错误，多线程同时解析时互不影响；
+// 出错时只写入错误码和偏移，消息文本在查询时才取出
 const char* json_get_error(void);
+JsonError json_get_last_error(void);
+const char* json_error_message(JsonErrorCode code);
+
+// 解析器自身记录的错误，行号和列号根据解析器的输入计算；
+// 增量解析器的偏移跨块累计，不保存输入，因此不计算行号和列号
+JsonError json_parser_get_error(const JsonParser* parser);
+
+// 根据出错的输入计算error的行号和列号
+void json_error_locate(JsonError* error, const char* json, size_t len);
 
 #endif // JSON_PARSER_H
\ No newline at end of file
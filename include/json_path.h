@@ -0,0 +1,35 @@
+#ifndef JSON_PATH_H
+#define JSON_PATH_H
+
+#include "json_parser.h"
+#include "json_cursor.h"
+
+// 编译选项
+typedef enum {
+    JSON_PATH_DEFAULT = 0,
+    JSON_PATH_WILDCARD = 1 << 0     // 内容恰为"*"的段匹配对象的任意成员或数组的任意元素
+} JsonPathFlags;
+
+// 编译后的JSON Pointer：各段已解码，键的哈希值已预先计算，可以反复求值
+typedef struct JsonPath JsonPath;
+
+// 编译RFC 6901 JSON Pointer："" 指向根，否则每段以'/'开始，段中的"~1"和"~0"分别表示'/'和'~'；
+// 格式无效时返回NULL并设置错误消息
+JsonPath* json_path_compile(const char* pointer, unsigned flags);
+JsonPath* json_path_compile_n(const char* pointer, size_t len, unsigned flags);
+void json_path_free(JsonPath* path);
+
+// 段数
+size_t json_path_segment_count(const JsonPath* path);
+
+// 在JsonValue树上求值，返回按文档顺序的第一个匹配；不存在时返回NULL
+JsonValue* json_path_get(const JsonPath* path, JsonValue* root);
+
+// 按文档顺序收集所有匹配，最多写入max个，返回匹配的总数
+size_t json_path_query(const JsonPath* path, JsonValue* root, JsonValue** results, size_t max);
+
+// 直接在原始输入上求值（root通常来自json_cursor_root）：沿路径跳过无关的子树，
+// 找到第一个匹配即停止，之后的输入不会被读取；不存在时返回的游标parser为NULL
+JsonCursor json_path_get_cursor(const JsonPath* path, JsonCursor root);
+
+#endif // JSON_PATH_H
@@ -0,0 +1,84 @@
+#ifndef JSON_TAPE_H
+#define JSON_TAPE_H
+
+#include "json_parser.h"
+
+// 磁带文档：整个文档保存为一段连续的64位字，字符串保存在另一块连续缓冲区中。
+// 每个字的高8位为类型标记，低56位为负载：
+//   '{' / '['  低32位为结束标记之后的位置（整个容器可以O(1)跳过），32-55位为成员数
+//   '}' / ']'  对应开始标记的位置
+//   '"'        字符串在字符串缓冲区中的偏移，该处依次为长度(size_t)、内容和'\0'
+//   'l' / 'u' / 'd'  int64 / uint64 / double，值保存在下一个字中
+//   't' / 'f' / 'n'  true / false / null
+// 对象的成员依次为键（'"'）和值
+typedef struct JsonTape JsonTape;
+
+// 磁带上某个值的位置；查找不到时tape为NULL
+typedef struct {
+    const JsonTape* tape;
+    size_t index;
+} JsonTapeRef;
+
+// 按顺序遍历容器的成员
+typedef struct {
+    const JsonTape* tape;
+    size_t index;       // 下一个成员的位置
+    size_t end;         // 容器结束标记的位置
+} JsonTapeIter;
+
+// 创建空磁带；同一磁带可以反复解析，已分配的缓冲区会被复用
+JsonTape* json_tape_create(void);
+void json_tape_free(JsonTape* tape);
+
+// 解析到磁带，flags只接受JSON_PARSE_INT64；失败时磁带为空
+bool json_tape_parse(JsonTape* tape, const char* json, size_t len, unsigned flags);
+
+// 创建磁带并解析，失败时返回NULL
+JsonTape* json_parse_tape(const char* json, size_t len, unsigned flags);
+
+// 磁带的字数
+size_t json_tape_word_count(const JsonTape* tape);
+
+// 根值
+JsonTapeRef json_tape_root(const JsonTape* tape);
+
+// 取值：类型不符时与对应的json_value_get_*行为相同
+JsonValueType json_tape_type(JsonTapeRef ref);
+bool json_tape_get_bool(JsonTapeRef ref);
+double json_tape_get_number(JsonTapeRef ref);
+int64_t json_tape_get_int64(JsonTapeRef ref);
+uint64_t json_tape_get_uint64(JsonTapeRef ref);
+const char* json_tape_get_string(JsonTapeRef ref, size_t* length);
+
+// 容器的成员数，不是容器时返回0
+size_t json_tape_size(JsonTapeRef ref);
+
+// 按下标或键查找：依次跳过前面的成员，每个成员都是O(1)；键重复时返回第一个
+JsonTapeRef json_tape_array_get(JsonTapeRef array, size_t index);
+JsonTapeRef json_tape_object_get(JsonTapeRef object, const char* key, size_t key_length);
+
+// 遍历：不是容器时迭代器为空；next在没有更多成员时返回false
+JsonTapeIter json_tape_iter(JsonTapeRef container);
+bool json_tape_array_next(JsonTapeIter* iter, JsonTapeRef* value);
+bool json_tape_object_next(JsonTapeIter* iter, const char** key, size_t* key_length, JsonTapeRef* value);
+
+// 把解析得到的值树转换为磁带，失败时返回NULL
+JsonTape* json_tape_from_value(const JsonValue* value);
+
+// 快照：磁带原样写成与位置无关的二进制格式（只有偏移，没有指针）。键在字符串区去重，
+// 成员数达到JSON_TAPE_TABLE_MIN_SIZE的容器附带查找表，按下标取元素为O(1)，按键查找走哈希。
+// 快照按本机字节序保存，加载时字节序或size_t宽度不同则拒绝
+#define JSON_TAPE_TABLE_MIN_SIZE 16
+
+// 生成快照到全局分配器分配的缓冲区（用json_free(NULL, ptr)释放），size接收字节数；失败时返回NULL
+void* json_tape_snapshot(const JsonTape* tape, size_t* size);
+bool json_tape_save(const JsonTape* tape, const char* path);
+
+// 加载快照，不做反序列化：json_tape_load只读映射文件，json_tape_free时解除映射；
+// json_tape_load_buffer直接使用data（须8字节对齐，在磁带释放前保持有效）。
+// 加载时扫描一遍磁带，校验字符串偏移、容器的开始和结束标记、成员数和查找表，
+// 损坏的快照返回NULL并设置JSON_ERROR_SNAPSHOT_FORMAT。加载的磁带不能再用于json_tape_parse
+JsonTape* json_tape_load(const char* path);
+JsonTape* json_tape_load_buffer(const void* data, size_t size);
+
+#endif // JSON_TAPE_H
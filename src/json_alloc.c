@@ -0,0 +1,132 @@
+#include "json_alloc.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 标准库分配器
+static void* libc_malloc(void* ctx, size_t size) {
+    (void)ctx;
+    return malloc(size);
+}
+
+static void* libc_realloc(void* ctx, void* ptr, size_t size) {
+    (void)ctx;
+    return realloc(ptr, size);
+}
+
+static void libc_free(void* ctx, void* ptr) {
+    (void)ctx;
+    free(ptr);
+}
+
+static const JsonAllocator libc_allocator = {libc_malloc, libc_realloc, libc_free, NULL};
+
+static JsonAllocator global_allocator = {libc_malloc, libc_realloc, libc_free, NULL};
+
+// 设置全局分配器
+void json_set_allocator(const JsonAllocator* allocator) {
+    global_allocator = allocator ? *allocator : libc_allocator;
+}
+
+const JsonAllocator* json_get_allocator(void) {
+    return &global_allocator;
+}
+
+void* json_malloc(const JsonAllocator* allocator, size_t size) {
+    if (!allocator) allocator = &global_allocator;
+    return allocator->malloc(allocator->ctx, size);
+}
+
+// 分配并清零，count * size溢出时返回NULL
+void* json_calloc(const JsonAllocator* allocator, size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void* ptr = json_malloc(allocator, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* json_realloc(const JsonAllocator* allocator, void* ptr, size_t size) {
+    if (!allocator) allocator = &global_allocator;
+    return allocator->realloc(allocator->ctx, ptr, size);
+}
+
+void json_free(const JsonAllocator* allocator, void* ptr) {
+    if (!ptr) return;
+    if (!allocator) allocator = &global_allocator;
+    allocator->free(allocator->ctx, ptr);
+}
+
+// ---------- 分配统计 ----------
+
+// 每块内存前的头部，保持与max_align_t相同的对齐
+typedef union {
+    size_t size;
+    max_align_t align;
+} StatsHeader;
+
+// 增加当前占用并更新峰值
+static void stats_grow(JsonAllocStats* stats, size_t size) {
+    size_t current = __atomic_add_fetch(&stats->current, size, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&stats->peak, __ATOMIC_RELAXED);
+    while (current > peak &&
+           !__atomic_compare_exchange_n(&stats->peak, &peak, current, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void* stats_malloc(void* ctx, size_t size) {
+    JsonAllocStats* stats = (JsonAllocStats*)ctx;
+    if (size > SIZE_MAX - sizeof(StatsHeader)) return NULL;
+    StatsHeader* header = (StatsHeader*)stats->parent.malloc(stats->parent.ctx, sizeof(StatsHeader) + size);
+    if (!header) return NULL;
+    header->size = size;
+    __atomic_add_fetch(&stats->allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->bytes, size, __ATOMIC_RELAXED);
+    stats_grow(stats, size);
+    return header + 1;
+}
+
+static void* stats_realloc(void* ctx, void* ptr, size_t size) {
+    JsonAllocStats* stats = (JsonAllocStats*)ctx;
+    if (!ptr) return stats_malloc(ctx, size);
+    if (size > SIZE_MAX - sizeof(StatsHeader)) return NULL;
+
+    StatsHeader* header = (StatsHeader*)ptr - 1;
+    size_t old_size = header->size;
+    header = (StatsHeader*)stats->parent.realloc(stats->parent.ctx, header, sizeof(StatsHeader) + size);
+    if (!header) return NULL;
+    header->size = size;
+    __atomic_add_fetch(&stats->allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->bytes, size, __ATOMIC_RELAXED);
+    if (size >= old_size) {
+        stats_grow(stats, size - old_size);
+    } else {
+        __atomic_sub_fetch(&stats->current, old_size - size, __ATOMIC_RELAXED);
+    }
+    return header + 1;
+}
+
+static void stats_free(void* ctx, void* ptr) {
+    JsonAllocStats* stats = (JsonAllocStats*)ctx;
+    if (!ptr) return;
+    StatsHeader* header = (StatsHeader*)ptr - 1;
+    __atomic_add_fetch(&stats->frees, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&stats->current, header->size, __ATOMIC_RELAXED);
+    stats->parent.free(stats->parent.ctx, header);
+}
+
+// 初始化统计：复制parent，之后更换全局分配器不影响已创建的计数分配器
+JsonAllocator json_alloc_stats_init(JsonAllocStats* stats, const JsonAllocator* parent) {
+    memset(stats, 0, sizeof(JsonAllocStats));
+    stats->parent = parent ? *parent : global_allocator;
+    JsonAllocator allocator = {stats_malloc, stats_realloc, stats_free, stats};
+    return allocator;
+}
+
+// 重置计数：未释放的内存仍计入current
+void json_alloc_stats_reset(JsonAllocStats* stats) {
+    __atomic_store_n(&stats->allocations, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->frees, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&stats->peak, __atomic_load_n(&stats->current, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+}
@@ -0,0 +1,170 @@
+#include "json_arena.h"
+#include <string.h>
+
+// 分配对齐字节数
+#define JSON_ARENA_ALIGN 8
+
+// 向上对齐
+static size_t align_up(size_t size) {
+    return (size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+}
+
+// 获取内存块的数据区
+static char* block_data(JsonArenaBlock* block) {
+    return (char*)(block + 1);
+}
+
+// 释放内存块链表
+static void free_blocks(JsonArena* arena, JsonArenaBlock* block) {
+    while (block) {
+        JsonArenaBlock* next = block->next;
+        json_free(arena->allocator, block);
+        block = next;
+    }
+}
+
+// 取出足够大的空闲内存块，没有时分配新的内存块，挂到链表头部
+static JsonArenaBlock* arena_add_block(JsonArena* arena, size_t min_size) {
+    JsonArenaBlock** link = &arena->spare;
+    while (*link && (*link)->size < min_size) link = &(*link)->next;
+
+    JsonArenaBlock* block = *link;
+    if (block) {
+        *link = block->next;
+    } else {
+        size_t size = arena->block_size;
+        if (size < min_size) size = min_size;
+        block = (JsonArenaBlock*)json_malloc(arena->allocator, sizeof(JsonArenaBlock) + size);
+        if (!block) return NULL;
+        block->size = size;
+    }
+
+    block->used = 0;
+    block->next = arena->head;
+    arena->head = block;
+    return block;
+}
+
+// 创建内存池
+JsonArena* json_arena_create(size_t block_size) {
+    return json_arena_create_with(block_size, NULL);
+}
+
+// 使用指定的分配器创建内存池
+JsonArena* json_arena_create_with(size_t block_size, const JsonAllocator* allocator) {
+    JsonArena* arena = (JsonArena*)json_malloc(allocator, sizeof(JsonArena));
+    if (!arena) return NULL;
+
+    arena->head = NULL;
+    arena->block_size = align_up(block_size ? block_size : JSON_ARENA_DEFAULT_BLOCK_SIZE);
+    arena->last = NULL;
+    arena->spare = NULL;
+    arena->allocator = allocator;
+    return arena;
+}
+
+// 释放内存池及其所有内存块
+void json_arena_free(JsonArena* arena) {
+    if (!arena) return;
+    free_blocks(arena, arena->head);
+    free_blocks(arena, arena->spare);
+    json_free(arena->allocator, arena);
+}
+
+// 重置内存池：保留一个标准大小的内存块以便复用，释放其余内存块
+void json_arena_reset(JsonArena* arena) {
+    if (!arena) return;
+
+    free_blocks(arena, arena->spare);
+    arena->spare = NULL;
+
+    JsonArenaBlock* keep = NULL;
+    JsonArenaBlock* block = arena->head;
+    while (block) {
+        JsonArenaBlock* next = block->next;
+        if (!keep && block->size == arena->block_size) {
+            keep = block;
+        } else {
+            json_free(arena->allocator, block);
+        }
+        block = next;
+    }
+
+    if (keep) {
+        keep->used = 0;
+        keep->next = NULL;
+    }
+    arena->head = keep;
+    arena->last = NULL;
+}
+
+// 回到空内存池：当前块继续作为头部，其余内存块移入空闲链表
+void json_arena_rewind(JsonArena* arena) {
+    if (!arena || !arena->head) return;
+
+    JsonArenaBlock* rest = arena->head->next;
+    if (rest) {
+        JsonArenaBlock* tail = rest;
+        while (tail->next) tail = tail->next;
+        tail->next = arena->spare;
+        arena->spare = rest;
+    }
+    arena->head->used = 0;
+    arena->head->next = NULL;
+    arena->last = NULL;
+}
+
+// 合并内存池：src的内存块接在dst的当前块之后，dst继续从当前块分配
+void json_arena_merge(JsonArena* dst, JsonArena* src) {
+    if (!dst || !src || dst == src || !src->head) return;
+
+    JsonArenaBlock* tail = src->head;
+    while (tail->next) tail = tail->next;
+
+    if (dst->head) {
+        tail->next = dst->head->next;
+        dst->head->next = src->head;
+    } else {
+        dst->head = src->head;
+    }
+    src->head = NULL;
+    src->last = NULL;
+}
+
+// 从内存池分配内存
+void* json_arena_alloc(JsonArena* arena, size_t size) {
+    size = align_up(size ? size : 1);
+
+    JsonArenaBlock* block = arena->head;
+    if (!block || block->size - block->used < size) {
+        block = arena_add_block(arena, size);
+        if (!block) return NULL;
+    }
+
+    void* ptr = block_data(block) + block->used;
+    block->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+// 调整内存大小：若为最近一次分配且空间足够则原地扩展，否则重新分配并复制
+void* json_arena_realloc(JsonArena* arena, void* ptr, size_t old_size, size_t new_size) {
+    if (!ptr) return json_arena_alloc(arena, new_size);
+
+    JsonArenaBlock* block = arena->head;
+    if (ptr == arena->last && block) {
+        size_t offset = (size_t)((char*)ptr - block_data(block));
+        size_t aligned = align_up(new_size ? new_size : 1);
+        if (block->size - offset >= aligned) {
+            block->used = offset + aligned;
+            return ptr;
+        }
+    }
+
+    if (new_size <= old_size) return ptr;
+
+    void* new_ptr = json_arena_alloc(arena, new_size);
+    if (!new_ptr) return NULL;
+    memcpy(new_ptr, ptr, old_size);
+    return new_ptr;
+}
@@ -1,40 +1,142 @@
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "json_builder.h"
+#include "json_dtoa.h"
+#include "json_escape.h"
+#include "json_simd.h"
 
-typedef struct {
-    char* buffer;
-    size_t capacity;
-    size_t length;
-} JsonBuilder;
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
 
 // 初始化JSON构建器
 JsonBuilder* json_builder_create(size_t initial_capacity) {
-    JsonBuilder* builder = (JsonBuilder*)malloc(sizeof(JsonBuilder));
+    return json_builder_create_with(initial_capacity, NULL);
+}
+
+// 使用指定的分配器初始化JSON构建器；缓冲区至少能容纳结尾的'\0'
+JsonBuilder* json_builder_create_with(size_t initial_capacity, const JsonAllocator* allocator) {
+    JsonBuilder* builder = (JsonBuilder*)json_malloc(allocator, sizeof(JsonBuilder));
     if (!builder) return NULL;
     
-    builder->buffer = (char*)malloc(initial_capacity);
+    if (initial_capacity == 0) initial_capacity = 1;
+    builder->buffer = (char*)json_malloc(allocator, initial_capacity);
     if (!builder->buffer) {
-        free(builder);
+        json_free(allocator, builder);
         return NULL;
     }
     
+    builder->allocator = allocator;
     builder->capacity = initial_capacity;
     builder->length = 0;
+    builder->flags = JSON_BUILDER_DEFAULT;
+    builder->write = NULL;
+    builder->write_ctx = NULL;
+    builder->fd = -1;
+    builder->failed = false;
     builder->buffer[0] = '\0';
     
     return builder;
 }
 
-// 确保缓冲区有足够空间
+// ---------- 输出目标 ----------
+
+static bool has_sink(const JsonBuilder* builder) {
+    return builder->write || builder->fd >= 0;
+}
+
+#ifdef _WIN32
+static bool fd_write(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        int n = _write(fd, data, len > 0x40000000 ? 0x40000000 : (unsigned)len);
+        if (n < 0) return false;
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+#else
+// 写出全部数据，处理部分写入和EINTR
+static bool fd_writev(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        size_t done = (size_t)n;
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+#endif
+
+// 依次写出两段数据，文件描述符用一次writev合并写入
+static bool sink_write(JsonBuilder* builder, const char* a, size_t a_len, const char* b, size_t b_len) {
+    if (builder->failed) return false;
+
+    bool ok;
+    if (builder->write) {
+        ok = (a_len == 0 || builder->write(builder->write_ctx, a, a_len)) &&
+             (b_len == 0 || builder->write(builder->write_ctx, b, b_len));
+    } else {
+#ifdef _WIN32
+        ok = fd_write(builder->fd, a, a_len) && fd_write(builder->fd, b, b_len);
+#else
+        struct iovec iov[2] = {{(void*)a, a_len}, {(void*)b, b_len}};
+        ok = fd_writev(builder->fd, iov, 2);
+#endif
+    }
+    if (!ok) builder->failed = true;
+    return ok;
+}
+
+// 写出缓冲区内容和紧随其后的extra；输出的最后一个字节是逗号时留在缓冲区中，
+// 结束对象或数组时仍可撤销
+static bool sink_flush(JsonBuilder* builder, const char* extra, size_t extra_len) {
+    size_t buffered = builder->length;
+    bool hold = false;
+    if (extra_len > 0) {
+        hold = extra[extra_len - 1] == ',';
+        extra_len -= hold;
+    } else if (buffered > 0) {
+        hold = builder->buffer[buffered - 1] == ',';
+        buffered -= hold;
+    }
+    if (!sink_write(builder, builder->buffer, buffered, extra, extra_len)) return false;
+
+    builder->length = 0;
+    if (hold) builder->buffer[builder->length++] = ',';
+    builder->buffer[builder->length] = '\0';
+    return true;
+}
+
+// 确保缓冲区有足够空间；输出到目标时先刷新，单次写入超过缓冲区大小时才扩容
 bool json_builder_ensure_capacity(JsonBuilder* builder, size_t additional) {
     if (builder->length + additional + 1 > builder->capacity) {
+        if (has_sink(builder)) {
+            if (!sink_flush(builder, NULL, 0)) return false;
+            if (builder->length + additional + 1 <= builder->capacity) return true;
+        }
         size_t new_capacity = builder->capacity * 2;
         if (new_capacity < builder->length + additional + 1)
             new_capacity = builder->length + additional + 1;
         
-        char* new_buffer = (char*)realloc(builder->buffer, new_capacity);
+        char* new_buffer = (char*)json_realloc(builder->allocator, builder->buffer, new_capacity);
         if (!new_buffer) return false;
         
         builder->buffer = new_buffer;
@@ -43,20 +145,37 @@ bool json_builder_ensure_capacity(JsonBuilder* builder, size_t additional) {
     return true;
 }
 
-// 添加字符串到构建器
-bool json_builder_append(JsonBuilder* builder, const char* str) {
-    size_t len = strlen(str);
+// 追加len字节，不要求以'\0'结尾；输出到目标且放不下时与缓冲区内容一起直接写出
+bool json_builder_append_n(JsonBuilder* builder, const char* str, size_t len) {
+    if (has_sink(builder) && builder->length + len + 1 > builder->capacity) {
+        return sink_flush(builder, str, len);
+    }
     if (!json_builder_ensure_capacity(builder, len)) return false;
-    
-    strcpy(builder->buffer + builder->length, str);
+
+    memcpy(builder->buffer + builder->length, str, len);
     builder->length += len;
-    
+    builder->buffer[builder->length] = '\0';
+
+    return true;
+}
+
+// 添加字符串到构建器
+bool json_builder_append(JsonBuilder* builder, const char* str) {
+    return json_builder_append_n(builder, str, strlen(str));
+}
+
+// 追加单个字符
+static bool append_char(JsonBuilder* builder, char c) {
+    if (!json_builder_ensure_capacity(builder, 1)) return false;
+
+    builder->buffer[builder->length++] = c;
+    builder->buffer[builder->length] = '\0';
     return true;
 }
 
 // 开始一个新的JSON对象
 bool json_builder_start_object(JsonBuilder* builder) {
-    return json_builder_append(builder, "{");
+    return append_char(builder, '{');
 }
 
 // 结束当前JSON对象
@@ -64,15 +183,14 @@ bool json_builder_end_object(JsonBuilder* builder) {
     // 移除最后一个逗号（如果有）
     if (builder->length > 0 && builder->buffer[builder->length - 1] == ',') {
         builder->buffer[builder->length - 1] = '}';
-    } else {
-        if (!json_builder_append(builder, "}")) return false;
+        return true;
     }
-    return true;
+    return append_char(builder, '}');
 }
 
 // 开始一个新的JSON数组
 bool json_builder_start_array(JsonBuilder* builder) {
-    return json_builder_append(builder, "[");
+    return append_char(builder, '[');
 }
 
 // 结束当前JSON数组
@@ -80,92 +198,436 @@ bool json_builder_end_array(JsonBuilder* builder) {
     // 移除最后一个逗号（如果有）
     if (builder->length > 0 && builder->buffer[builder->length - 1] == ',') {
         builder->buffer[builder->length - 1] = ']';
-    } else {
-        if (!json_builder_append(builder, "]")) return false;
+        return true;
     }
+    return append_char(builder, ']');
+}
+
+// ---------- 键值对：预留一次空间后直接写入缓冲区 ----------
+
+// 字符串写入后的长度（含两侧引号）；*first为第一个需要转义的位置，
+// 绝大多数字符串无需转义，只扫描一遍
+static size_t escaped_size(const char* str, size_t len, bool ascii_only, size_t* first) {
+    *first = json_simd_find_escape(str, 0, len, ascii_only);
+    if (*first == len) return len + 2;
+    return *first + json_escaped_length(str + *first, len - *first, ascii_only) + 2;
+}
+
+static size_t quoted_length(const JsonBuilder* builder, const char* str, size_t len, size_t* first) {
+    return escaped_size(str, len, (builder->flags & JSON_BUILDER_ASCII) != 0, first);
+}
+
+// 写入带引号的字符串，无需转义的部分整段复制
+static char* write_quoted(const JsonBuilder* builder, char* p, const char* str, size_t len, size_t first) {
+    *p++ = '\"';
+    memcpy(p, str, first);
+    p += first;
+    if (first < len) p = json_escape(p, str + first, len - first, (builder->flags & JSON_BUILDER_ASCII) != 0);
+    *p++ = '\"';
+    return p;
+}
+
+// 写入值之后的逗号并更新长度
+static bool end_pair(JsonBuilder* builder, char* p) {
+    *p++ = ',';
+    *p = '\0';
+    builder->length = (size_t)(p - builder->buffer);
     return true;
 }
 
-// 添加字符串键值对
-bool json_builder_add_string(JsonBuilder* builder, const char* key, const char* value) {
-    if (!json_builder_ensure_capacity(builder, strlen(key) + strlen(value) + 10)) 
-        return false;
-    
-    char* escaped_value = NULL;
-    size_t escaped_len = 0;
-    
-    // 简单的字符串转义处理
-    for (const char* p = value; *p; p++) {
-        if (*p == '\"' || *p == '\\' || *p == '\n' || *p == '\r' || *p == '\t')
-            escaped_len += 2;
-        else
-            escaped_len++;
+// 预留"key":、最长为value_max的值和逗号，返回值的写入位置
+static char* begin_pair(JsonBuilder* builder, const char* key, size_t key_len, size_t value_max) {
+    size_t key_first;
+    size_t key_size = quoted_length(builder, key, key_len, &key_first);
+    if (!json_builder_ensure_capacity(builder, key_size + value_max + 2)) return NULL;
+
+    char* p = write_quoted(builder, builder->buffer + builder->length, key, key_len, key_first);
+    *p++ = ':';
+    return p;
+}
+
+// 输出到目标时分段写入长字符串的内容（不含引号）：较长的无需转义的片段直接写出，
+// 其余部分按缓冲区剩余空间分块转义
+static bool stream_escaped(JsonBuilder* builder, const char* str, size_t len) {
+    bool ascii_only = (builder->flags & JSON_BUILDER_ASCII) != 0;
+    size_t pos = 0;
+    while (pos < len) {
+        size_t clean = json_simd_find_escape(str, pos, len, ascii_only);
+        if (clean > pos && !json_builder_append_n(builder, str + pos, clean - pos)) return false;
+        pos = clean;
+        if (pos == len) break;
+
+        if (builder->length + 1 + JSON_ESCAPE_MAX_EXPANSION * 4 > builder->capacity &&
+            !sink_flush(builder, NULL, 0)) {
+            return false;
+        }
+        size_t end = pos + (builder->capacity - builder->length - 1) / JSON_ESCAPE_MAX_EXPANSION;
+        if (end >= len) {
+            end = len;
+        } else if (ascii_only) {
+            // 不在UTF-8字符中间切开：向前退到首字节，连续超过3个后续字节时原本就是无效序列
+            size_t back = end;
+            while (back > end - 3 && ((unsigned char)str[back] & 0xC0) == 0x80) back--;
+            if (((unsigned char)str[back] & 0xC0) != 0x80) end = back;
+        }
+        char* p = json_escape(builder->buffer + builder->length, str + pos, end - pos, ascii_only);
+        builder->length = (size_t)(p - builder->buffer);
+        builder->buffer[builder->length] = '\0';
+        pos = end;
     }
-    
-    escaped_value = (char*)malloc(escaped_len + 1);
-    if (!escaped_value) return false;
-    
-    char* q = escaped_value;
-    for (const char* p = value; *p; p++) {
-        if (*p == '\"') { *q++ = '\\'; *q++ = '\"'; }
-        else if (*p == '\\') { *q++ = '\\'; *q++ = '\\'; }
-        else if (*p == '\n') { *q++ = '\\'; *q++ = 'n'; }
-        else if (*p == '\r') { *q++ = '\\'; *q++ = 'r'; }
-        else if (*p == '\t') { *q++ = '\\'; *q++ = 't'; }
-        else *q++ = *p;
-    }
-    *q = '\0';
-    
-    char temp[1024];
-    sprintf(temp, "\"%s\":\"%s\",", key, escaped_value);
-    free(escaped_value);
-    
-    return json_builder_append(builder, temp);
+    return true;
+}
+
+// 输出到目标时写入放不下缓冲区的字符串键值对
+static bool add_large_string(JsonBuilder* builder, const char* key, size_t key_len,
+                             const char* value, size_t value_len) {
+    char* p = begin_pair(builder, key, key_len, 1);
+    if (!p) return false;
+    *p++ = '\"';
+    builder->length = (size_t)(p - builder->buffer);
+
+    if (!stream_escaped(builder, value, value_len)) return false;
+    if (!json_builder_ensure_capacity(builder, 2)) return false;
+    p = builder->buffer + builder->length;
+    *p++ = '\"';
+    return end_pair(builder, p);
+}
+
+// 添加字符串键值对：先确定转义后的准确长度，再一次写入
+bool json_builder_add_string_n(JsonBuilder* builder, const char* key, size_t key_len,
+                               const char* value, size_t value_len) {
+    size_t value_first;
+    size_t value_size = quoted_length(builder, value, value_len, &value_first);
+    if (has_sink(builder) && value_size > builder->capacity / 2) {
+        return add_large_string(builder, key, key_len, value, value_len);
+    }
+    char* p = begin_pair(builder, key, key_len, value_size);
+    if (!p) return false;
+    return end_pair(builder, write_quoted(builder, p, value, value_len, value_first));
+}
+
+bool json_builder_add_string(JsonBuilder* builder, const char* key, const char* value) {
+    return json_builder_add_string_n(builder, key, strlen(key), value, strlen(value));
+}
+
+// 添加数字键值对：输出能还原为同一个double的最短表示
+bool json_builder_add_number_n(JsonBuilder* builder, const char* key, size_t key_len, double value) {
+    char* p = begin_pair(builder, key, key_len, JSON_NUMBER_MAX_LENGTH);
+    if (!p) return false;
+    return end_pair(builder, p + json_format_double(p, value));
 }
 
-// 添加数字键值对
 bool json_builder_add_number(JsonBuilder* builder, const char* key, double value) {
-    if (!json_builder_ensure_capacity(builder, strlen(key) + 32)) 
-        return false;
-    
-    char temp[1024];
-    sprintf(temp, "\"%s\":%.10g,", key, value);
-    
-    return json_builder_append(builder, temp);
+    return json_builder_add_number_n(builder, key, strlen(key), value);
+}
+
+// 添加整数键值对
+bool json_builder_add_int64_n(JsonBuilder* builder, const char* key, size_t key_len, int64_t value) {
+    char* p = begin_pair(builder, key, key_len, JSON_NUMBER_MAX_LENGTH);
+    if (!p) return false;
+    return end_pair(builder, p + json_format_int64(p, value));
+}
+
+bool json_builder_add_int64(JsonBuilder* builder, const char* key, int64_t value) {
+    return json_builder_add_int64_n(builder, key, strlen(key), value);
+}
+
+bool json_builder_add_uint64_n(JsonBuilder* builder, const char* key, size_t key_len, uint64_t value) {
+    char* p = begin_pair(builder, key, key_len, JSON_NUMBER_MAX_LENGTH);
+    if (!p) return false;
+    return end_pair(builder, p + json_format_uint64(p, value));
+}
+
+bool json_builder_add_uint64(JsonBuilder* builder, const char* key, uint64_t value) {
+    return json_builder_add_uint64_n(builder, key, strlen(key), value);
 }
 
 // 添加布尔键值对
+bool json_builder_add_bool_n(JsonBuilder* builder, const char* key, size_t key_len, bool value) {
+    char* p = begin_pair(builder, key, key_len, 5);
+    if (!p) return false;
+
+    if (value) {
+        memcpy(p, "true", 4);
+        p += 4;
+    } else {
+        memcpy(p, "false", 5);
+        p += 5;
+    }
+    return end_pair(builder, p);
+}
+
 bool json_builder_add_bool(JsonBuilder* builder, const char* key, bool value) {
-    if (!json_builder_ensure_capacity(builder, strlen(key) + 10)) 
-        return false;
-    
-    char temp[1024];
-    sprintf(temp, "\"%s\":%s,", key, value ? "true" : "false");
-    
-    return json_builder_append(builder, temp);
+    return json_builder_add_bool_n(builder, key, strlen(key), value);
 }
 
 // 添加null键值对
+bool json_builder_add_null_n(JsonBuilder* builder, const char* key, size_t key_len) {
+    char* p = begin_pair(builder, key, key_len, 4);
+    if (!p) return false;
+
+    memcpy(p, "null", 4);
+    return end_pair(builder, p + 4);
+}
+
 bool json_builder_add_null(JsonBuilder* builder, const char* key) {
-    if (!json_builder_ensure_capacity(builder, strlen(key) + 10)) 
-        return false;
-    
-    char temp[1024];
-    sprintf(temp, "\"%s\":null,", key);
-    
-    return json_builder_append(builder, temp);
+    return json_builder_add_null_n(builder, key, strlen(key));
+}
+
+// ---------- 序列化JsonValue树 ----------
+
+static size_t format_number(char* out, const JsonValue* value) {
+    switch (value->type) {
+        case JSON_INT64: return json_format_int64(out, value->value.int64);
+        case JSON_UINT64: return json_format_uint64(out, value->value.uint64);
+        default: return json_format_double(out, value->value.number);
+    }
+}
+
+// 容器内n个成员在美化输出时额外的换行和缩进
+static size_t pretty_overhead(size_t n, size_t depth) {
+    if (n == 0) return 0;
+    return n * (1 + (depth + 1) * JSON_SERIALIZE_INDENT) + 1 + depth * JSON_SERIALIZE_INDENT;
+}
+
+static size_t serialized_length(const JsonValue* value, bool pretty, bool ascii_only, size_t depth) {
+    char number[JSON_NUMBER_MAX_LENGTH];
+    size_t first;
+    switch (value->type) {
+        case JSON_NULL:
+            return 4;
+        case JSON_BOOL:
+            return value->value.boolean ? 4 : 5;
+        case JSON_NUMBER:
+        case JSON_INT64:
+        case JSON_UINT64:
+            return format_number(number, value);
+        case JSON_STRING:
+            return escaped_size(value->value.string, value->length, ascii_only, &first);
+        case JSON_ARRAY: {
+            const JsonArray* array = value->value.array;
+            size_t total = 2 + (array->size ? array->size - 1 : 0);
+            if (pretty) total += pretty_overhead(array->size, depth);
+            for (size_t i = 0; i < array->size; i++) {
+                total += serialized_length(array->elements[i], pretty, ascii_only, depth + 1);
+            }
+            return total;
+        }
+        case JSON_OBJECT: {
+            const JsonObject* object = value->value.object;
+            size_t total = 2 + (object->size ? object->size - 1 : 0);
+            if (pretty) total += pretty_overhead(object->size, depth) + object->size;   // ": "中的空格
+            for (size_t i = 0; i < object->size; i++) {
+                const JsonKeyValue* pair = &object->pairs[i];
+                total += escaped_size(pair->key, pair->key_length, ascii_only, &first) + 1;
+                total += serialized_length(pair->value, pretty, ascii_only, depth + 1);
+            }
+            return total;
+        }
+    }
+    return 0;
+}
+
+size_t json_value_serialized_length(const JsonValue* value, unsigned flags) {
+    if (!value) return 0;
+    return serialized_length(value, (flags & JSON_SERIALIZE_PRETTY) != 0,
+                             (flags & JSON_SERIALIZE_ASCII) != 0, 0);
+}
+
+// 以下写入函数在内存模式下空间已预留，ensure_capacity只做一次比较；
+// 中间不写'\0'，由调用者在结束时补上
+static bool write_string(JsonBuilder* builder, const char* str, size_t len) {
+    size_t first;
+    size_t size = quoted_length(builder, str, len, &first);
+    if (has_sink(builder) && size > builder->capacity / 2) {
+        return append_char(builder, '\"') && stream_escaped(builder, str, len) && append_char(builder, '\"');
+    }
+    if (!json_builder_ensure_capacity(builder, size)) return false;
+    char* p = write_quoted(builder, builder->buffer + builder->length, str, len, first);
+    builder->length = (size_t)(p - builder->buffer);
+    return true;
+}
+
+// 剩余空间不足最大长度时（按准确长度分配的缓冲区末尾）先格式化到临时缓冲区
+static bool write_number(JsonBuilder* builder, const JsonValue* value) {
+    if (builder->capacity - builder->length > JSON_NUMBER_MAX_LENGTH) {
+        builder->length += format_number(builder->buffer + builder->length, value);
+        return true;
+    }
+    char number[JSON_NUMBER_MAX_LENGTH];
+    size_t n = format_number(number, value);
+    if (!json_builder_ensure_capacity(builder, n)) return false;
+    memcpy(builder->buffer + builder->length, number, n);
+    builder->length += n;
+    return true;
+}
+
+static bool write_punct(JsonBuilder* builder, char c) {
+    if (!json_builder_ensure_capacity(builder, 1)) return false;
+    builder->buffer[builder->length++] = c;
+    return true;
+}
+
+// 换行并缩进到depth层
+static bool write_indent(JsonBuilder* builder, size_t depth) {
+    size_t n = depth * JSON_SERIALIZE_INDENT;
+    if (!json_builder_ensure_capacity(builder, n + 1)) return false;
+    char* p = builder->buffer + builder->length;
+    *p++ = '\n';
+    memset(p, ' ', n);
+    builder->length += n + 1;
+    return true;
+}
+
+static bool write_value(JsonBuilder* builder, const JsonValue* value, bool pretty, size_t depth) {
+    switch (value->type) {
+        case JSON_NULL:
+            return json_builder_append_n(builder, "null", 4);
+        case JSON_BOOL:
+            return value->value.boolean ? json_builder_append_n(builder, "true", 4)
+                                        : json_builder_append_n(builder, "false", 5);
+        case JSON_NUMBER:
+        case JSON_INT64:
+        case JSON_UINT64:
+            return write_number(builder, value);
+        case JSON_STRING:
+            return write_string(builder, value->value.string, value->length);
+        case JSON_ARRAY: {
+            const JsonArray* array = value->value.array;
+            if (!write_punct(builder, '[')) return false;
+            for (size_t i = 0; i < array->size; i++) {
+                if (i > 0 && !write_punct(builder, ',')) return false;
+                if (pretty && !write_indent(builder, depth + 1)) return false;
+                if (!write_value(builder, array->elements[i], pretty, depth + 1)) return false;
+            }
+            if (pretty && array->size > 0 && !write_indent(builder, depth)) return false;
+            return write_punct(builder, ']');
+        }
+        case JSON_OBJECT: {
+            const JsonObject* object = value->value.object;
+            if (!write_punct(builder, '{')) return false;
+            for (size_t i = 0; i < object->size; i++) {
+                const JsonKeyValue* pair = &object->pairs[i];
+                if (i > 0 && !write_punct(builder, ',')) return false;
+                if (pretty && !write_indent(builder, depth + 1)) return false;
+                if (!write_string(builder, pair->key, pair->key_length) || !write_punct(builder, ':')) return false;
+                if (pretty && !write_punct(builder, ' ')) return false;
+                if (!write_value(builder, pair->value, pretty, depth + 1)) return false;
+            }
+            if (pretty && object->size > 0 && !write_indent(builder, depth)) return false;
+            return write_punct(builder, '}');
+        }
+    }
+    return false;
+}
+
+// 内存模式下先按准确长度预留空间，JSON_SERIALIZE_ASCII只在本次写入时生效
+static bool serialize_into(JsonBuilder* builder, const JsonValue* value, unsigned flags) {
+    unsigned saved_flags = builder->flags;
+    if (flags & JSON_SERIALIZE_ASCII) builder->flags |= JSON_BUILDER_ASCII;
+    bool pretty = (flags & JSON_SERIALIZE_PRETTY) != 0;
+
+    bool ok = true;
+    if (!has_sink(builder)) {
+        size_t size = serialized_length(value, pretty, (builder->flags & JSON_BUILDER_ASCII) != 0, 0);
+        ok = json_builder_ensure_capacity(builder, size);
+    }
+    ok = ok && write_value(builder, value, pretty, 0);
+    builder->buffer[builder->length] = '\0';
+    builder->flags = saved_flags;
+    return ok;
+}
+
+bool json_value_serialize(const JsonValue* value, JsonBuilder* builder, unsigned flags) {
+    if (!value || !builder) return false;
+    return serialize_into(builder, value, flags);
+}
+
+bool json_builder_add_value_n(JsonBuilder* builder, const char* key, size_t key_len,
+                              const JsonValue* value, unsigned flags) {
+    if (!value) return false;
+    char* p = begin_pair(builder, key, key_len, 0);
+    if (!p) return false;
+    builder->length = (size_t)(p - builder->buffer);
+    return serialize_into(builder, value, flags) && append_char(builder, ',');
+}
+
+bool json_builder_add_value(JsonBuilder* builder, const char* key, const JsonValue* value, unsigned flags) {
+    return json_builder_add_value_n(builder, key, strlen(key), value, flags);
+}
+
+// 序列化为新字符串：按准确长度只分配一次
+char* json_value_to_string(const JsonValue* value, unsigned flags, size_t* length) {
+    if (!value) return NULL;
+    size_t size = json_value_serialized_length(value, flags);
+    JsonBuilder builder = {0};
+    builder.buffer = (char*)json_malloc(NULL, size + 1);
+    if (!builder.buffer) return NULL;
+    builder.capacity = size + 1;
+    builder.fd = -1;
+    builder.flags = (flags & JSON_SERIALIZE_ASCII) ? JSON_BUILDER_ASCII : JSON_BUILDER_DEFAULT;
+
+    write_value(&builder, value, (flags & JSON_SERIALIZE_PRETTY) != 0, 0);
+    builder.buffer[builder.length] = '\0';
+    if (length) *length = builder.length;
+    return builder.buffer;
 }
 
 // 获取构建的JSON字符串
 const char* json_builder_get_string(JsonBuilder* builder) {
-    return builder->buffer;
+    return has_sink(builder) ? NULL : builder->buffer;
+}
+
+// ---------- 创建输出到目标的构建器 ----------
+
+static JsonBuilder* create_sink(size_t buffer_size) {
+    if (buffer_size == 0) buffer_size = JSON_BUILDER_SINK_BUFFER_SIZE;
+    if (buffer_size < JSON_BUILDER_SINK_MIN_BUFFER) buffer_size = JSON_BUILDER_SINK_MIN_BUFFER;
+    return json_builder_create(buffer_size);
+}
+
+JsonBuilder* json_builder_create_fd(int fd, size_t buffer_size) {
+    if (fd < 0) return NULL;
+    JsonBuilder* builder = create_sink(buffer_size);
+    if (builder) builder->fd = fd;
+    return builder;
+}
+
+static bool file_write(void* ctx, const char* data, size_t len) {
+    return fwrite(data, 1, len, (FILE*)ctx) == len;
+}
+
+JsonBuilder* json_builder_create_file(FILE* file, size_t buffer_size) {
+    if (!file) return NULL;
+    return json_builder_create_callback(file_write, file, buffer_size);
+}
+
+JsonBuilder* json_builder_create_callback(JsonBuilderWriteFn write, void* ctx, size_t buffer_size) {
+    if (!write) return NULL;
+    JsonBuilder* builder = create_sink(buffer_size);
+    if (builder) {
+        builder->write = write;
+        builder->write_ctx = ctx;
+    }
+    return builder;
+}
+
+// 写出缓冲区内容
+bool json_builder_flush(JsonBuilder* builder) {
+    if (!has_sink(builder)) return true;
+    return sink_flush(builder, NULL, 0);
+}
+
+// 设置构建选项（JsonBuilderFlags组合），对之后写入的内容生效
+void json_builder_set_flags(JsonBuilder* builder, unsigned flags) {
+    builder->flags = flags;
 }
 
 // 释放JSON构建器
 void json_builder_free(JsonBuilder* builder) {
     if (builder) {
-        free(builder->buffer);
-        free(builder);
+        json_free(builder->allocator, builder->buffer);
+        json_free(builder->allocator, builder);
     }
 }
 
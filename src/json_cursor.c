@@ -0,0 +1,361 @@
+#include "json_cursor.h"
+#include "json_internal.h"
+#include "json_number.h"
+#include "json_simd.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const JsonCursor missing = {NULL, 0};
+
+// 创建按需解析用的解析器：只记录输入，不做任何解析
+JsonParser* json_parser_create_lazy(const char* json, size_t len, unsigned flags) {
+    if (!json) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (flags & ~(unsigned)(JSON_PARSE_INT64 | JSON_PARSE_VIEWS)) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return NULL;
+    }
+
+    JsonParser* parser = json_parser_create_n(json, len);
+    if (!parser) return NULL;
+    parser->arena = json_arena_create(0);
+    if (!parser->arena) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        json_parser_free(parser);
+        return NULL;
+    }
+    parser->owns_arena = true;
+    parser->flags = flags;
+    return parser;
+}
+
+// ---------- 在原始输入上移动 ----------
+
+static size_t skip_whitespace(const JsonParser* parser, size_t pos) {
+    return json_simd_skip_whitespace(parser->json, pos, parser->len);
+}
+
+static char char_at(const JsonParser* parser, size_t pos) {
+    return pos < parser->len ? parser->json[pos] : '\0';
+}
+
+// 值之后允许出现的字符
+static bool is_delimiter(char c) {
+    return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\0';
+}
+
+// pos为开始引号，返回结束引号的位置，has_escape记录是否含转义；未结束时返回len
+static size_t string_end(const JsonParser* parser, size_t pos, bool* has_escape) {
+    *has_escape = false;
+    pos++;
+    for (;;) {
+        pos = json_simd_find_quote_or_backslash(parser->json, pos, parser->len);
+        if (pos >= parser->len) return parser->len;
+        if (parser->json[pos] == '"') return pos;
+        *has_escape = true;
+        pos += 2;
+    }
+}
+
+// 跳过pos处的整个值，不解码也不分配内存：容器用括号匹配，字符串找结束引号，
+// 数字和字面量找分隔符
+static bool skip_value(JsonParser* parser, size_t* pos) {
+    size_t p = *pos;
+    char c = char_at(parser, p);
+    if (c == '{' || c == '[') {
+        size_t end = json_simd_skip_container(parser->json, p, parser->len);
+        if (end == 0) {
+            json_parser_set_error(parser, c == '{' ? JSON_ERROR_UNTERMINATED_OBJECT : JSON_ERROR_UNTERMINATED_ARRAY, p);
+            return false;
+        }
+        *pos = end;
+        return true;
+    }
+    if (c == '"') {
+        bool has_escape;
+        size_t end = string_end(parser, p, &has_escape);
+        if (end >= parser->len) {
+            json_parser_set_error(parser, JSON_ERROR_UNTERMINATED_STRING, p);
+            return false;
+        }
+        *pos = end + 1;
+        return true;
+    }
+    while (p < parser->len && !is_delimiter(parser->json[p])) p++;
+    if (p == *pos) {
+        json_parser_set_error(parser, JSON_ERROR_INVALID_VALUE, p);
+        return false;
+    }
+    *pos = p;
+    return true;
+}
+
+// 取出容器的下一个成员：对象成员给出键的原始区间（不含引号），数组元素的键区间为空
+static bool member_next(JsonCursorIter* iter, size_t* key_start, size_t* key_end,
+                        bool* key_escaped, size_t* value_pos) {
+    if (!iter->parser || iter->done) return false;
+    JsonParser* parser = iter->parser;
+    char close = iter->object ? '}' : ']';
+
+    size_t pos = iter->pos;
+    if (iter->started && !skip_value(parser, &pos)) goto fail;
+    pos = skip_whitespace(parser, pos);
+    char c = char_at(parser, pos);
+    if (c == close) {
+        iter->done = true;
+        return false;
+    }
+    if (iter->started) {
+        if (c != ',') {
+            json_parser_set_error(parser, iter->object ? JSON_ERROR_EXPECTED_OBJECT_SEPARATOR : JSON_ERROR_EXPECTED_ARRAY_SEPARATOR, pos);
+            goto fail;
+        }
+        pos = skip_whitespace(parser, pos + 1);
+    }
+
+    *key_start = *key_end = pos;
+    *key_escaped = false;
+    if (iter->object) {
+        if (char_at(parser, pos) != '"') {
+            json_parser_set_error(parser, JSON_ERROR_EXPECTED_STRING, pos);
+            goto fail;
+        }
+        size_t end = string_end(parser, pos, key_escaped);
+        if (end >= parser->len) {
+            json_parser_set_error(parser, JSON_ERROR_UNTERMINATED_STRING, pos);
+            goto fail;
+        }
+        *key_start = pos + 1;
+        *key_end = end;
+        pos = skip_whitespace(parser, end + 1);
+        if (char_at(parser, pos) != ':') {
+            json_parser_set_error(parser, JSON_ERROR_EXPECTED_COLON, pos);
+            goto fail;
+        }
+        pos = skip_whitespace(parser, pos + 1);
+    }
+    if (pos >= parser->len) {
+        json_parser_set_error(parser, JSON_ERROR_INVALID_VALUE, pos);
+        goto fail;
+    }
+
+    *value_pos = pos;
+    iter->pos = pos;
+    iter->started = true;
+    return true;
+
+fail:
+    iter->done = true;
+    return false;
+}
+
+// 比较原始键与查找的键，含转义时先解码
+static bool key_equals(const char* raw, size_t raw_len, bool escaped, const char* key, size_t key_length) {
+    if (!escaped) return raw_len == key_length && memcmp(raw, key, key_length) == 0;
+    if (raw_len < key_length) return false;     // 解码只会变短
+
+    char small[256];
+    char* decoded = raw_len <= sizeof(small) ? small : (char*)json_malloc(NULL, raw_len);
+    if (!decoded) return false;
+    size_t n = json_unescape_string(decoded, raw, raw_len, NULL);
+    bool equal = n == key_length && memcmp(decoded, key, key_length) == 0;
+    if (decoded != small) json_free(NULL, decoded);
+    return equal;
+}
+
+// 解码字符串到解析器的内存池
+static const char* decode_string(JsonParser* parser, size_t start, size_t end, size_t* length) {
+    char* str = (char*)json_arena_alloc(parser->arena, end - start + 1);
+    if (!str) {
+        json_parser_set_error(parser, JSON_ERROR_OUT_OF_MEMORY, start);
+        return NULL;
+    }
+    size_t bad = 0;
+    *length = json_unescape_string(str, parser->json + start, end - start, &bad);
+    if (*length == JSON_UNESCAPE_INVALID) {
+        json_parser_set_error(parser, JSON_ERROR_INVALID_ESCAPE, start + bad);
+        return NULL;
+    }
+    str[*length] = '\0';
+    return str;
+}
+
+// ---------- 公开接口 ----------
+
+JsonCursor json_cursor_root(JsonParser* parser) {
+    if (!parser) return missing;
+    size_t pos = skip_whitespace(parser, 0);
+    if (pos >= parser->len) {
+        json_parser_set_error(parser, JSON_ERROR_INVALID_VALUE, pos);
+        return missing;
+    }
+    JsonCursor cursor = {parser, pos};
+    return cursor;
+}
+
+JsonValueType json_cursor_type(JsonCursor cursor) {
+    if (!cursor.parser) return JSON_NULL;
+    char c = char_at(cursor.parser, cursor.pos);
+    switch (c) {
+        case '{': return JSON_OBJECT;
+        case '[': return JSON_ARRAY;
+        case '"': return JSON_STRING;
+        case 't':
+        case 'f': return JSON_BOOL;
+        case 'n': return JSON_NULL;
+        default: break;
+    }
+    if (c != '-' && (c < '0' || c > '9')) {
+        json_parser_set_error(cursor.parser, JSON_ERROR_INVALID_VALUE, cursor.pos);
+        return JSON_NULL;
+    }
+    if (cursor.parser->flags & JSON_PARSE_INT64) {
+        JsonNumber number;
+        if (json_number_parse(cursor.parser->json + cursor.pos, cursor.parser->len - cursor.pos, &number)) {
+            if (number.kind == JSON_NUMBER_INT64) return JSON_INT64;
+            if (number.kind == JSON_NUMBER_UINT64) return JSON_UINT64;
+        }
+    }
+    return JSON_NUMBER;
+}
+
+JsonCursorIter json_cursor_iter(JsonCursor container) {
+    JsonCursorIter iter = {NULL, 0, false, false, true};
+    if (!container.parser) return iter;
+    char c = char_at(container.parser, container.pos);
+    if (c != '{' && c != '[') return iter;
+    iter.parser = container.parser;
+    iter.pos = container.pos + 1;
+    iter.object = c == '{';
+    iter.done = false;
+    return iter;
+}
+
+bool json_cursor_next(JsonCursorIter* iter, const char** key, size_t* key_length, JsonCursor* value) {
+    size_t key_start, key_end, value_pos;
+    bool escaped;
+    if (!member_next(iter, &key_start, &key_end, &escaped, &value_pos)) return false;
+
+    if (key || key_length) {
+        const char* k = NULL;
+        size_t n = 0;
+        if (iter->object) {
+            n = key_end - key_start;
+            k = escaped ? decode_string(iter->parser, key_start, key_end, &n) : iter->parser->json + key_start;
+            if (!k) {
+                iter->done = true;
+                return false;
+            }
+        }
+        if (key) *key = k;
+        if (key_length) *key_length = n;
+    }
+    value->parser = iter->parser;
+    value->pos = value_pos;
+    return true;
+}
+
+JsonCursor json_cursor_get(JsonCursor object, const char* key, size_t key_length) {
+    if (!key || json_cursor_type(object) != JSON_OBJECT) return missing;
+    JsonCursorIter iter = json_cursor_iter(object);
+    size_t key_start, key_end, value_pos;
+    bool escaped;
+    while (member_next(&iter, &key_start, &key_end, &escaped, &value_pos)) {
+        if (key_equals(object.parser->json + key_start, key_end - key_start, escaped, key, key_length)) {
+            JsonCursor value = {object.parser, value_pos};
+            return value;
+        }
+    }
+    return missing;
+}
+
+JsonCursor json_cursor_at(JsonCursor array, size_t index) {
+    if (json_cursor_type(array) != JSON_ARRAY) return missing;
+    JsonCursorIter iter = json_cursor_iter(array);
+    size_t key_start, key_end, value_pos;
+    bool escaped;
+    while (member_next(&iter, &key_start, &key_end, &escaped, &value_pos)) {
+        if (index-- == 0) {
+            JsonCursor value = {array.parser, value_pos};
+            return value;
+        }
+    }
+    return missing;
+}
+
+const char* json_cursor_get_string(JsonCursor cursor, size_t* length) {
+    size_t n = 0;
+    const char* str = NULL;
+    if (cursor.parser && char_at(cursor.parser, cursor.pos) == '"') {
+        bool escaped;
+        size_t end = string_end(cursor.parser, cursor.pos, &escaped);
+        if (end >= cursor.parser->len) {
+            json_parser_set_error(cursor.parser, JSON_ERROR_UNTERMINATED_STRING, cursor.pos);
+        } else if (escaped) {
+            str = decode_string(cursor.parser, cursor.pos + 1, end, &n);
+        } else {
+            str = cursor.parser->json + cursor.pos + 1;
+            n = end - cursor.pos - 1;
+        }
+    }
+    if (length) *length = str ? n : 0;
+    return str;
+}
+
+// 解析数字，数字之后必须是分隔符；结果转换为JsonValue以沿用json_value_get_*的转换规则
+static bool cursor_number(JsonCursor cursor, JsonValue* value) {
+    if (!cursor.parser) return false;
+    JsonParser* parser = cursor.parser;
+    JsonNumber number;
+    size_t n = json_number_parse(parser->json + cursor.pos, parser->len - cursor.pos, &number);
+    if (n == 0 || !is_delimiter(char_at(parser, cursor.pos + n))) {
+        json_parser_set_error(parser, JSON_ERROR_INVALID_NUMBER, cursor.pos);
+        return false;
+    }
+    switch (number.kind) {
+        case JSON_NUMBER_INT64:
+            value->type = JSON_INT64;
+            value->value.int64 = number.value.i;
+            break;
+        case JSON_NUMBER_UINT64:
+            value->type = JSON_UINT64;
+            value->value.uint64 = number.value.u;
+            break;
+        default:
+            value->type = JSON_NUMBER;
+            value->value.number = number.value.d;
+            break;
+    }
+    return true;
+}
+
+double json_cursor_get_number(JsonCursor cursor) {
+    JsonValue value;
+    return cursor_number(cursor, &value) ? json_value_get_number(&value) : 0.0;
+}
+
+int64_t json_cursor_get_int64(JsonCursor cursor) {
+    JsonValue value;
+    return cursor_number(cursor, &value) ? json_value_get_int64(&value) : 0;
+}
+
+uint64_t json_cursor_get_uint64(JsonCursor cursor) {
+    JsonValue value;
+    return cursor_number(cursor, &value) ? json_value_get_uint64(&value) : 0;
+}
+
+bool json_cursor_get_bool(JsonCursor cursor) {
+    if (!cursor.parser) return false;
+    const JsonParser* parser = cursor.parser;
+    return parser->len - cursor.pos >= 4 && memcmp(parser->json + cursor.pos, "true", 4) == 0 &&
+           is_delimiter(char_at(parser, cursor.pos + 4));
+}
+
+// 从游标位置开始用递归下降解析器构建子树
+JsonValue* json_cursor_value(JsonCursor cursor) {
+    if (!cursor.parser) return NULL;
+    cursor.parser->pos = cursor.pos;
+    return json_parse_value(cursor.parser);
+}
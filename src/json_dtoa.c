@@ -0,0 +1,345 @@
+#include "json_dtoa.h"
+#include <string.h>
+
+// Grisu2（Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"）：
+// 输出的数字串一定能还原为同一个double，绝大多数情况下也是最短的
+
+// 64位尾数和二进制指数表示的浮点数 f * 2^e
+typedef struct {
+    uint64_t f;
+    int e;
+} DiyFp;
+
+#define DP_SIGNIFICAND_SIZE 52
+#define DP_EXPONENT_BIAS (0x3FF + DP_SIGNIFICAND_SIZE)
+#define DP_MIN_EXPONENT (-DP_EXPONENT_BIAS)
+#define DP_HIDDEN_BIT (1ULL << DP_SIGNIFICAND_SIZE)
+#define DP_SIGNIFICAND_MASK (DP_HIDDEN_BIT - 1)
+
+// 10^k（k = -348 + 8i）规格化后的64位近似值及其二进制指数
+static const uint64_t cached_powers_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL,
+    0x8b16fb203055ac76ULL, 0xcf42894a5dce35eaULL,
+    0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL,
+    0xbe5691ef416bd60cULL, 0x8dd01fad907ffc3cULL,
+    0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL,
+    0x823c12795db6ce57ULL, 0xc21094364dfb5637ULL,
+    0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL,
+    0xb23867fb2a35b28eULL, 0x84c8d4dfd2c63f3bULL,
+    0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL,
+    0xf3e2f893dec3f126ULL, 0xb5b5ada8aaff80b8ULL,
+    0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL,
+    0xa6dfbd9fb8e5b88fULL, 0xf8a95fcf88747d94ULL,
+    0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL,
+    0xe45c10c42a2b3b06ULL, 0xaa242499697392d3ULL,
+    0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL,
+    0x9c40000000000000ULL, 0xe8d4a51000000000ULL,
+    0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL,
+    0xd5d238a4abe98068ULL, 0x9f4f2726179a2245ULL,
+    0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL,
+    0x924d692ca61be758ULL, 0xda01ee641a708deaULL,
+    0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL,
+    0xc83553c5c8965d3dULL, 0x952ab45cfa97a0b3ULL,
+    0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL,
+    0x88fcf317f22241e2ULL, 0xcc20ce9bd35c78a5ULL,
+    0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL,
+    0xbb764c4ca7a44410ULL, 0x8bab8eefb6409c1aULL,
+    0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL,
+    0x80444b5e7aa7cf85ULL, 0xbf21e44003acdd2dULL,
+    0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL,
+    0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const uint64_t pow10_table[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL, 10000000000000000000ULL
+};
+
+// 两位数字查找表
+static const char digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static DiyFp diyfp_from_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased_e = (int)((bits >> DP_SIGNIFICAND_SIZE) & 0x7FF);
+    DiyFp v;
+    v.f = bits & DP_SIGNIFICAND_MASK;
+    if (biased_e != 0) {
+        v.f += DP_HIDDEN_BIT;
+        v.e = biased_e - DP_EXPONENT_BIAS;
+    } else {
+        v.e = DP_MIN_EXPONENT + 1;
+    }
+    return v;
+}
+
+// 乘积取高64位并四舍五入
+static DiyFp diyfp_mul(DiyFp a, DiyFp b) {
+    __uint128_t p = (__uint128_t)a.f * b.f;
+    DiyFp r;
+    r.f = (uint64_t)(p >> 64);
+    if ((uint64_t)p & (1ULL << 63)) r.f++;
+    r.e = a.e + b.e + 64;
+    return r;
+}
+
+static DiyFp diyfp_normalize(DiyFp v) {
+    int s = __builtin_clzll(v.f);
+    v.f <<= s;
+    v.e -= s;
+    return v;
+}
+
+// 计算v的舍入边界（与相邻double的中点），两者指数相同
+static void diyfp_boundaries(DiyFp v, DiyFp* minus, DiyFp* plus) {
+    DiyFp pl;
+    pl.f = (v.f << 1) + 1;
+    pl.e = v.e - 1;
+    while (!(pl.f & (DP_HIDDEN_BIT << 1))) {
+        pl.f <<= 1;
+        pl.e--;
+    }
+    pl.f <<= 64 - DP_SIGNIFICAND_SIZE - 2;
+    pl.e -= 64 - DP_SIGNIFICAND_SIZE - 2;
+
+    DiyFp mi;
+    if (v.f == DP_HIDDEN_BIT) {
+        mi.f = (v.f << 2) - 1;
+        mi.e = v.e - 2;
+    } else {
+        mi.f = (v.f << 1) - 1;
+        mi.e = v.e - 1;
+    }
+    mi.f <<= mi.e - pl.e;
+    mi.e = pl.e;
+
+    *minus = mi;
+    *plus = pl;
+}
+
+// 选取使乘积指数落在[-60, -32]的10的幂，返回其十进制指数的相反数
+static DiyFp cached_power(int e, int* k) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if (dk - ik > 0.0) ik++;
+    unsigned index = (unsigned)((ik >> 3) + 1);
+    *k = -(-348 + (int)(index << 3));
+    DiyFp c;
+    c.f = cached_powers_f[index];
+    c.e = cached_powers_e[index];
+    return c;
+}
+
+static int count_digits32(uint32_t n) {
+    int digits = 1;
+    while (digits < 10 && n >= pow10_table[digits]) digits++;
+    return digits;
+}
+
+// 在允许范围内把最后一位向真实值靠拢
+static void grisu_round(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+// 逐位生成数字，直到结果落入(Mp - delta, Mp)区间
+static int digit_gen(DiyFp w, DiyFp mp, uint64_t delta, char* buffer, int* k) {
+    int shift = -mp.e;
+    uint64_t one = 1ULL << shift;
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    int kappa = count_digits32(p1);
+    int len = 0;
+
+    while (kappa > 0) {
+        uint32_t divisor = (uint32_t)pow10_table[kappa - 1];
+        uint32_t d = p1 / divisor;
+        p1 %= divisor;
+        if (d || len) buffer[len++] = (char)('0' + d);
+        kappa--;
+        uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            grisu_round(buffer, len, delta, rest, pow10_table[kappa] << shift, wp_w);
+            return len;
+        }
+    }
+
+    for (;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> shift);
+        if (d || len) buffer[len++] = (char)('0' + d);
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            int index = -kappa;
+            grisu_round(buffer, len, delta, p2, one, index < 20 ? wp_w * pow10_table[index] : 0);
+            return len;
+        }
+    }
+}
+
+// 生成有效数字，value = buffer * 10^k，value必须为正的有限值
+static int grisu2(double value, char* buffer, int* k) {
+    DiyFp v = diyfp_from_double(value);
+    DiyFp w_m, w_p;
+    diyfp_boundaries(v, &w_m, &w_p);
+
+    DiyFp c_mk = cached_power(w_p.e, k);
+    DiyFp w = diyfp_mul(diyfp_normalize(v), c_mk);
+    DiyFp wp = diyfp_mul(w_p, c_mk);
+    DiyFp wm = diyfp_mul(w_m, c_mk);
+    wm.f++;
+    wp.f--;
+    return digit_gen(w, wp, wp.f - wm.f, buffer, k);
+}
+
+// 写十进制指数：'e'、可选的负号以及不带前导零的数字
+static char* write_exponent(char* out, int exponent) {
+    *out++ = 'e';
+    if (exponent < 0) {
+        *out++ = '-';
+        exponent = -exponent;
+    }
+    if (exponent >= 100) {
+        *out++ = (char)('0' + exponent / 100);
+        exponent %= 100;
+        memcpy(out, digit_pairs + exponent * 2, 2);
+        return out + 2;
+    }
+    if (exponent >= 10) {
+        memcpy(out, digit_pairs + exponent * 2, 2);
+        return out + 2;
+    }
+    *out++ = (char)('0' + exponent);
+    return out;
+}
+
+// 按数量级选择定点或科学计数法排版digits * 10^k
+static char* prettify(char* out, const char* digits, int len, int k) {
+    int point = len + k;    // 小数点相对于第一位数字的位置
+
+    if (k >= 0 && point <= 21) {
+        // 整数：1234e7 -> 12340000000
+        memcpy(out, digits, (size_t)len);
+        memset(out + len, '0', (size_t)k);
+        return out + point;
+    }
+    if (point > 0 && point <= 21) {
+        // 1234e-2 -> 12.34
+        memcpy(out, digits, (size_t)point);
+        out[point] = '.';
+        memcpy(out + point + 1, digits + point, (size_t)(len - point));
+        return out + len + 1;
+    }
+    if (point > -6 && point <= 0) {
+        // 1234e-6 -> 0.001234
+        out[0] = '0';
+        out[1] = '.';
+        memset(out + 2, '0', (size_t)-point);
+        memcpy(out + 2 - point, digits, (size_t)len);
+        return out + 2 - point + len;
+    }
+    if (len == 1) {
+        // 1e30
+        *out++ = digits[0];
+        return write_exponent(out, point - 1);
+    }
+    // 1234e30 -> 1.234e33
+    *out++ = digits[0];
+    *out++ = '.';
+    memcpy(out, digits + 1, (size_t)(len - 1));
+    return write_exponent(out + len - 1, point - 1);
+}
+
+size_t json_format_uint64(char* out, uint64_t value) {
+    char temp[20];
+    char* p = temp + sizeof(temp);
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100);
+        value /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + pair * 2, 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + value * 2, 2);
+    } else {
+        *--p = (char)('0' + value);
+    }
+    size_t len = (size_t)(temp + sizeof(temp) - p);
+    memcpy(out, p, len);
+    return len;
+}
+
+size_t json_format_int64(char* out, int64_t value) {
+    if (value < 0) {
+        *out = '-';
+        return 1 + json_format_uint64(out + 1, 0 - (uint64_t)value);
+    }
+    return json_format_uint64(out, (uint64_t)value);
+}
+
+size_t json_format_double(char* out, double value) {
+    if (value != value || value - value != 0) {
+        // NaN和无穷大不是合法的JSON数字
+        memcpy(out, "null", 4);
+        return 4;
+    }
+
+    // 2^53以内的整数走整数路径
+    if (value >= -9007199254740992.0 && value <= 9007199254740992.0 && value == (double)(int64_t)value) {
+        if (value == 0 && 1 / value < 0) {
+            memcpy(out, "-0", 2);
+            return 2;
+        }
+        return json_format_int64(out, (int64_t)value);
+    }
+
+    char* p = out;
+    if (value < 0) {
+        *p++ = '-';
+        value = -value;
+    }
+    char digits[24];
+    int k;
+    int len = grisu2(value, digits, &k);
+    return (size_t)(prettify(p, digits, len, k) - out);
+}
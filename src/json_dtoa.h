@@ -0,0 +1,18 @@
+#ifndef JSON_DTOA_H
+#define JSON_DTOA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 库内部使用的数字格式化，不依赖区域设置，输出不以'\0'结尾
+
+// 单个数字格式化后的最大字节数
+#define JSON_NUMBER_MAX_LENGTH 32
+
+// 输出能还原为同一个double的最短数字串；2^53以内的整数按整数输出，NaN和无穷大输出null
+size_t json_format_double(char* out, double value);
+
+size_t json_format_int64(char* out, int64_t value);
+size_t json_format_uint64(char* out, uint64_t value);
+
+#endif // JSON_DTOA_H
@@ -0,0 +1,115 @@
+#include "json_escape.h"
+#include "json_simd.h"
+#include <stdint.h>
+#include <string.h>
+
+// 每个ASCII字节的转义方式：0为原样输出，'u'为\u00XX，其余为反斜杠后跟该字符
+static const char escape_table[256] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    0,   0,   '"', 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   '\\', 0,  0,   0
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+// 解码一个UTF-8字符，拒绝过长编码、代理区和超出范围的码点，无效时返回-1
+static int32_t decode_utf8(const unsigned char* s, size_t len, size_t* consumed) {
+    unsigned char c = s[0];
+    size_t n;
+    int32_t cp;
+    int32_t min;
+    if (c >= 0xC2 && c < 0xE0) {
+        n = 2;
+        cp = c & 0x1F;
+        min = 0x80;
+    } else if (c >= 0xE0 && c < 0xF0) {
+        n = 3;
+        cp = c & 0x0F;
+        min = 0x800;
+    } else if (c >= 0xF0 && c < 0xF5) {
+        n = 4;
+        cp = c & 0x07;
+        min = 0x10000;
+    } else {
+        return -1;
+    }
+    if (n > len) return -1;
+    for (size_t i = 1; i < n; i++) {
+        if ((s[i] & 0xC0) != 0x80) return -1;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return -1;
+    *consumed = n;
+    return cp;
+}
+
+static void write_u(char* out, unsigned cp) {
+    out[0] = '\\';
+    out[1] = 'u';
+    out[2] = hex_digits[(cp >> 12) & 0xF];
+    out[3] = hex_digits[(cp >> 8) & 0xF];
+    out[4] = hex_digits[(cp >> 4) & 0xF];
+    out[5] = hex_digits[cp & 0xF];
+}
+
+// 转义pos处的字符，out为NULL时只计算长度；返回写入的字节数，*consumed为消耗的输入字节数
+static size_t escape_at(const char* str, size_t len, size_t pos, char* out, size_t* consumed) {
+    unsigned char c = (unsigned char)str[pos];
+    *consumed = 1;
+    if (c < 0x80) {
+        char escape = escape_table[c];
+        if (escape != 'u') {
+            if (out) {
+                out[0] = '\\';
+                out[1] = escape;
+            }
+            return 2;
+        }
+        if (out) write_u(out, c);
+        return 6;
+    }
+
+    int32_t cp = decode_utf8((const unsigned char*)str + pos, len - pos, consumed);
+    if (cp < 0) cp = 0xFFFD;
+    if (cp < 0x10000) {
+        if (out) write_u(out, (unsigned)cp);
+        return 6;
+    }
+    // 基本多文种平面之外的字符写成代理对
+    cp -= 0x10000;
+    if (out) {
+        write_u(out, 0xD800 + ((unsigned)cp >> 10));
+        write_u(out + 6, 0xDC00 + ((unsigned)cp & 0x3FF));
+    }
+    return 12;
+}
+
+size_t json_escaped_length(const char* str, size_t len, bool ascii_only) {
+    size_t total = 0;
+    size_t pos = 0;
+    for (;;) {
+        size_t next = json_simd_find_escape(str, pos, len, ascii_only);
+        total += next - pos;
+        if (next >= len) return total;
+        size_t consumed;
+        total += escape_at(str, len, next, NULL, &consumed);
+        pos = next + consumed;
+    }
+}
+
+// 无需转义的连续片段整段复制
+char* json_escape(char* out, const char* str, size_t len, bool ascii_only) {
+    size_t pos = 0;
+    for (;;) {
+        size_t next = json_simd_find_escape(str, pos, len, ascii_only);
+        memcpy(out, str + pos, next - pos);
+        out += next - pos;
+        if (next >= len) return out;
+        size_t consumed;
+        out += escape_at(str, len, next, out, &consumed);
+        pos = next + consumed;
+    }
+}
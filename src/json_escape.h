@@ -0,0 +1,19 @@
+#ifndef JSON_ESCAPE_H
+#define JSON_ESCAPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 库内部使用的字符串转义：'"'、'\\'和全部控制字符，ascii_only时非ASCII字符输出为\uXXXX
+// （无效的UTF-8字节输出为\uFFFD）
+
+// 单个输入字节转义后的最大字节数
+#define JSON_ESCAPE_MAX_EXPANSION 6
+
+// 转义后的字节数（不含两侧引号）
+size_t json_escaped_length(const char* str, size_t len, bool ascii_only);
+
+// 写入转义后的内容，out至少需要json_escaped_length字节，返回写入结束位置
+char* json_escape(char* out, const char* str, size_t len, bool ascii_only);
+
+#endif // JSON_ESCAPE_H
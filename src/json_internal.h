@@ -0,0 +1,51 @@
+#ifndef JSON_INTERNAL_H
+#define JSON_INTERNAL_H
+
+#include "json_parser.h"
+#include "json_number.h"
+
+// 库内部各模块共享的函数，不属于公开接口
+
+// 记录本线程最近一次的错误；只写入错误码和偏移，不复制消息
+void json_set_error(JsonErrorCode code);
+void json_set_error_at(JsonErrorCode code, size_t offset);
+
+// 同时记录到解析器
+void json_parser_set_error(JsonParser* parser, JsonErrorCode code, size_t offset);
+
+// json_unescape_string遇到无效转义时的返回值
+#define JSON_UNESCAPE_INVALID ((size_t)-1)
+
+// 反转义src中的n个字节（不含两侧引号）写入dst，返回写入的字节数；dst可以与src相同。
+// 支持JSON的全部转义，\uXXXX（含代理对）解码为UTF-8；未知转义、无效的十六进制数和
+// 单独的代理项返回JSON_UNESCAPE_INVALID，error_pos非空时接收反斜杠在src中的偏移
+size_t json_unescape_string(char* dst, const char* src, size_t n, size_t* error_pos);
+
+// 计算键的哈希值
+uint32_t json_hash_key(const char* key, size_t len);
+
+// 用预先计算的哈希值按键查找对象成员，hash必须等于json_hash_key(key, key_length)
+JsonValue* json_object_get_hashed(const JsonObject* object, const char* key, size_t key_length, uint32_t hash);
+
+// 对象哈希索引所需的槽位数，小对象返回0
+size_t json_object_index_slots(size_t size);
+
+// 用已清零的slots建立对象的哈希索引
+void json_object_fill_index(JsonObject* object, uint32_t* slots, size_t slot_count);
+
+// 以精确值接收数字的回调
+typedef bool (*JsonExactNumberFn)(void* ctx, const JsonNumber* number);
+
+// 事件解析，exact_number代替handler->number接收数字；回调中止时不设置错误消息
+bool json_parse_events_exact(const char* json, size_t len, const JsonHandler* handler,
+                             JsonExactNumberFn exact_number, void* ctx);
+
+// 只读映射文件（JSON_PARSE_INSITU时为私有可写映射），不支持mmap的平台读入堆缓冲区；
+// 失败时返回NULL并设置错误
+void* json_map_file(const char* path, unsigned flags, size_t* size);
+void json_unmap_file(void* mapping, size_t size);
+
+// 释放增量解析状态
+void json_push_state_free(struct JsonPushState* push);
+
+#endif // JSON_INTERNAL_H
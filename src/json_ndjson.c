@@ -0,0 +1,306 @@
+#include "json_ndjson.h"
+#include "json_internal.h"
+#include "json_simd.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// 一条记录在输入中的位置
+typedef struct {
+    size_t start;
+    size_t len;
+} NdjsonRecord;
+
+// 工作线程：先处理自己的连续区间，做完后从其他线程的区间领取剩余记录
+typedef struct {
+    _Alignas(64) atomic_size_t next;   // 区间内下一条待领取的记录，所有线程共用
+    size_t end;
+    JsonArena* arena;
+    struct JsonNdjsonIter* iter;
+} NdjsonWorker;
+
+struct JsonNdjsonIter {
+    const char* json;
+    NdjsonRecord* records;
+    size_t count;
+    JsonDocument** documents;
+    const char** errors;
+    JsonError* record_errors;   // 偏移已加上记录的起始位置
+    atomic_uchar* done;         // 每条记录是否已解析完
+
+    NdjsonWorker* workers;
+    void* workers_block;        // workers所在的内存块：分配器不保证缓存行对齐，workers在其中向上对齐
+    size_t worker_count;
+    pthread_t* threads;
+    size_t thread_count;
+    atomic_bool cancel;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+
+    size_t pos;                 // 迭代位置
+    const char* error;          // 最近取出记录的错误消息
+    JsonError last_error;       // 最近取出记录的错误
+};
+
+// 按换行符切分记录，跳过空白行（合法JSON的字符串内不会出现裸换行）
+static bool split_records(JsonNdjsonIter* iter, const char* json, size_t len) {
+    size_t capacity = 64;
+    iter->records = (NdjsonRecord*)json_malloc(NULL, sizeof(NdjsonRecord) * capacity);
+    if (!iter->records) return false;
+
+    size_t pos = 0;
+    while (pos < len) {
+        const char* newline = (const char*)memchr(json + pos, '\n', len - pos);
+        size_t end = newline ? (size_t)(newline - json) : len;
+        if (json_simd_skip_whitespace(json, pos, end) < end) {
+            if (iter->count >= capacity) {
+                capacity *= 2;
+                NdjsonRecord* new_records = (NdjsonRecord*)json_realloc(NULL, iter->records,
+                                                                   sizeof(NdjsonRecord) * capacity);
+                if (!new_records) return false;
+                iter->records = new_records;
+            }
+            iter->records[iter->count].start = pos;
+            iter->records[iter->count].len = end - pos;
+            iter->count++;
+        }
+        pos = end + 1;
+    }
+    return true;
+}
+
+// 解析一条记录；错误消息是静态字符串，无需复制，错误偏移换算为相对整个输入
+static void parse_record(NdjsonWorker* worker, size_t i) {
+    JsonNdjsonIter* iter = worker->iter;
+    const NdjsonRecord* record = &iter->records[i];
+    iter->documents[i] = json_parse_into_n(worker->arena, iter->json + record->start, record->len);
+    if (!iter->documents[i]) {
+        iter->errors[i] = json_get_error();
+        iter->record_errors[i] = json_get_last_error();
+        iter->record_errors[i].offset += record->start;
+    }
+    atomic_store_explicit(&iter->done[i], 1, memory_order_release);
+}
+
+// 工作线程主循环
+static void* worker_run(void* arg) {
+    NdjsonWorker* self = (NdjsonWorker*)arg;
+    JsonNdjsonIter* iter = self->iter;
+    size_t id = (size_t)(self - iter->workers);
+
+    for (size_t k = 0; k < iter->worker_count; k++) {
+        NdjsonWorker* victim = &iter->workers[(id + k) % iter->worker_count];
+        for (;;) {
+            if (atomic_load_explicit(&iter->cancel, memory_order_relaxed)) return NULL;
+            size_t first = atomic_fetch_add(&victim->next, JSON_NDJSON_GRAIN);
+            if (first >= victim->end) break;
+            size_t last = first + JSON_NDJSON_GRAIN < victim->end ? first + JSON_NDJSON_GRAIN : victim->end;
+            for (size_t i = first; i < last; i++) parse_record(self, i);
+
+            // 唤醒等待中的迭代器
+            pthread_mutex_lock(&iter->lock);
+            pthread_cond_broadcast(&iter->ready);
+            pthread_mutex_unlock(&iter->lock);
+        }
+    }
+    return NULL;
+}
+
+// 切分输入并为各工作线程分配连续区间，不启动线程
+static JsonNdjsonIter* iter_prepare(const char* json, size_t len, size_t threads) {
+    if (!json) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    JsonNdjsonIter* iter = (JsonNdjsonIter*)json_calloc(NULL, 1, sizeof(JsonNdjsonIter));
+    if (!iter) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    iter->json = json;
+    pthread_mutex_init(&iter->lock, NULL);
+    pthread_cond_init(&iter->ready, NULL);
+    atomic_init(&iter->cancel, false);
+
+    if (!split_records(iter, json, len)) goto fail;
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t)online : 1;
+    }
+    // 记录太少时不值得启动多个线程
+    size_t max_workers = iter->count / JSON_NDJSON_GRAIN;
+    if (threads > max_workers) threads = max_workers ? max_workers : 1;
+
+    size_t slots = iter->count ? iter->count : 1;
+    iter->documents = (JsonDocument**)json_calloc(NULL, slots, sizeof(JsonDocument*));
+    iter->errors = (const char**)json_calloc(NULL, slots, sizeof(const char*));
+    iter->record_errors = (JsonError*)json_calloc(NULL, slots, sizeof(JsonError));
+    iter->done = (atomic_uchar*)json_calloc(NULL, slots, sizeof(atomic_uchar));
+    iter->workers_block = json_malloc(NULL, sizeof(NdjsonWorker) * threads + _Alignof(NdjsonWorker) - 1);
+    if (iter->workers_block) {
+        uintptr_t aligned = ((uintptr_t)iter->workers_block + _Alignof(NdjsonWorker) - 1) &
+                            ~(uintptr_t)(_Alignof(NdjsonWorker) - 1);
+        iter->workers = (NdjsonWorker*)aligned;
+    }
+    iter->threads = (pthread_t*)json_malloc(NULL, sizeof(pthread_t) * threads);
+    if (!iter->documents || !iter->errors || !iter->record_errors || !iter->done || !iter->workers || !iter->threads) goto fail;
+
+    iter->worker_count = threads;
+    for (size_t w = 0; w < threads; w++) {
+        NdjsonWorker* worker = &iter->workers[w];
+        atomic_init(&worker->next, iter->count * w / threads);
+        worker->end = iter->count * (w + 1) / threads;
+        worker->iter = iter;
+        worker->arena = json_arena_create(0);
+        if (!worker->arena) {
+            iter->worker_count = w;
+            goto fail;
+        }
+    }
+    return iter;
+
+fail:
+    json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+    json_ndjson_iter_free(iter);
+    return NULL;
+}
+
+// 为工作线程[first, worker_count)启动线程
+static bool iter_start(JsonNdjsonIter* iter, size_t first) {
+    for (size_t w = first; w < iter->worker_count; w++) {
+        if (pthread_create(&iter->threads[iter->thread_count], NULL, worker_run, &iter->workers[w]) != 0) {
+            json_set_error(JSON_ERROR_THREAD_CREATE);
+            return false;
+        }
+        iter->thread_count++;
+    }
+    return true;
+}
+
+// 等待所有线程结束
+static void iter_join(JsonNdjsonIter* iter) {
+    for (size_t t = 0; t < iter->thread_count; t++) pthread_join(iter->threads[t], NULL);
+    iter->thread_count = 0;
+}
+
+// 批量解析：调用线程也作为0号工作线程参与解析
+JsonNdjsonBatch* json_parse_ndjson(const char* json, size_t len, size_t threads) {
+    JsonNdjsonIter* iter = iter_prepare(json, len, threads);
+    if (!iter) return NULL;
+
+    JsonNdjsonBatch* batch = (JsonNdjsonBatch*)json_calloc(NULL, 1, sizeof(JsonNdjsonBatch));
+    if (!batch) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        json_ndjson_iter_free(iter);
+        return NULL;
+    }
+    batch->arenas = (JsonArena**)json_malloc(NULL, sizeof(JsonArena*) * iter->worker_count);
+    if (!batch->arenas) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        json_free(NULL, batch);
+        json_ndjson_iter_free(iter);
+        return NULL;
+    }
+
+    bool started = iter_start(iter, 1);
+    if (started) worker_run(&iter->workers[0]);
+    else atomic_store(&iter->cancel, true);
+    iter_join(iter);
+    if (!started) {
+        json_free(NULL, batch->arenas);
+        json_free(NULL, batch);
+        json_ndjson_iter_free(iter);
+        return NULL;
+    }
+
+    // 结果和内存池的所有权转交给batch
+    batch->documents = iter->documents;
+    batch->errors = iter->errors;
+    batch->record_errors = iter->record_errors;
+    batch->count = iter->count;
+    for (size_t i = 0; i < iter->count; i++) {
+        if (!batch->documents[i]) batch->error_count++;
+    }
+    for (size_t w = 0; w < iter->worker_count; w++) {
+        batch->arenas[w] = iter->workers[w].arena;
+        iter->workers[w].arena = NULL;
+    }
+    batch->arena_count = iter->worker_count;
+    iter->documents = NULL;
+    iter->errors = NULL;
+    iter->record_errors = NULL;
+    json_ndjson_iter_free(iter);
+    return batch;
+}
+
+// 释放批量解析结果
+void json_ndjson_batch_free(JsonNdjsonBatch* batch) {
+    if (!batch) return;
+    for (size_t w = 0; w < batch->arena_count; w++) json_arena_free(batch->arenas[w]);
+    json_free(NULL, batch->arenas);
+    json_free(NULL, batch->documents);
+    json_free(NULL, (void*)batch->errors);
+    json_free(NULL, batch->record_errors);
+    json_free(NULL, batch);
+}
+
+// 创建流式迭代器并立即在后台开始解析
+JsonNdjsonIter* json_ndjson_iter_create(const char* json, size_t len, size_t threads) {
+    JsonNdjsonIter* iter = iter_prepare(json, len, threads);
+    if (!iter) return NULL;
+    if (!iter_start(iter, 0)) {
+        json_ndjson_iter_free(iter);
+        return NULL;
+    }
+    return iter;
+}
+
+// 按输入顺序取出下一条记录，必要时等待其解析完成
+bool json_ndjson_iter_next(JsonNdjsonIter* iter, JsonDocument** doc) {
+    if (iter->pos >= iter->count) return false;
+
+    size_t i = iter->pos++;
+    if (!atomic_load_explicit(&iter->done[i], memory_order_acquire)) {
+        pthread_mutex_lock(&iter->lock);
+        while (!atomic_load_explicit(&iter->done[i], memory_order_acquire)) {
+            pthread_cond_wait(&iter->ready, &iter->lock);
+        }
+        pthread_mutex_unlock(&iter->lock);
+    }
+    *doc = iter->documents[i];
+    iter->error = iter->errors[i];
+    iter->last_error = iter->record_errors[i];
+    return true;
+}
+
+// 最近取出记录的错误消息，成功时为NULL
+const char* json_ndjson_iter_error(const JsonNdjsonIter* iter) {
+    return iter->error;
+}
+
+// 最近取出记录的错误码和偏移
+JsonError json_ndjson_iter_last_error(const JsonNdjsonIter* iter) {
+    return iter->last_error;
+}
+
+// 释放迭代器：未取完时通知线程提前结束
+void json_ndjson_iter_free(JsonNdjsonIter* iter) {
+    if (!iter) return;
+    atomic_store(&iter->cancel, true);
+    iter_join(iter);
+    for (size_t w = 0; w < iter->worker_count; w++) json_arena_free(iter->workers[w].arena);
+    pthread_mutex_destroy(&iter->lock);
+    pthread_cond_destroy(&iter->ready);
+    json_free(NULL, iter->records);
+    json_free(NULL, iter->documents);
+    json_free(NULL, (void*)iter->errors);
+    json_free(NULL, iter->record_errors);
+    json_free(NULL, iter->done);
+    json_free(NULL, iter->workers_block);
+    json_free(NULL, iter->threads);
+    json_free(NULL, iter);
+}
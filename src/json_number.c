@@ -0,0 +1,251 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     // strtod_l
+#endif
+#include "json_number.h"
+#include "json_pow5_table.h"
+#include "json_alloc.h"
+#include <locale.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+#endif
+
+// double能精确表示的10的幂，用于Clinger快速路径
+static const double exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// ---------- 回退路径：固定使用"C"区域设置的strtod ----------
+
+#ifdef _WIN32
+static double c_strtod(const char* text, char** endptr) {
+    static _locale_t c_locale;
+    if (!c_locale) c_locale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(text, endptr, c_locale);
+}
+#else
+static locale_t c_locale;
+static pthread_once_t c_locale_once = PTHREAD_ONCE_INIT;
+
+static void c_locale_init(void) {
+    c_locale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+}
+
+static double c_strtod(const char* text, char** endptr) {
+    pthread_once(&c_locale_once, c_locale_init);
+    if (c_locale) return strtod_l(text, endptr, c_locale);
+    return strtod(text, endptr);
+}
+#endif
+
+// 复制数字文本后交给strtod，只在快速路径无法保证正确舍入时使用
+static bool fallback_strtod(const char* json, size_t len, double* out) {
+    char temp[64];
+    char* text = temp;
+    if (len >= sizeof(temp)) {
+        text = (char*)json_malloc(NULL, len + 1);
+        if (!text) return false;
+    }
+    memcpy(text, json, len);
+    text[len] = '\0';
+    *out = c_strtod(text, NULL);
+    if (text != temp) json_free(NULL, text);
+    return true;
+}
+
+// ---------- Eisel-Lemire ----------
+
+// 计算w * 10^q的正确舍入结果；结果可能落在两个double正中间或为次正规数时返回false
+static bool eisel_lemire(int64_t q, uint64_t w, bool negative, double* out) {
+    if (q < JSON_POW5_MIN_EXPONENT) {
+        *out = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (q > JSON_POW5_MAX_EXPONENT) {
+        *out = negative ? -HUGE_VAL : HUGE_VAL;
+        return true;
+    }
+
+    // 规格化w，与5^q的128位近似值相乘；2^q部分只影响指数
+    size_t index = (size_t)(q - JSON_POW5_MIN_EXPONENT) * 2;
+    int lz = __builtin_clzll(w);
+    w <<= lz;
+    __uint128_t product = (__uint128_t)w * json_pow5_table[index];
+    uint64_t lower = (uint64_t)product;
+    uint64_t upper = (uint64_t)(product >> 64);
+
+    // 高位可能受截断误差影响时再乘上低64位
+    if ((upper & 0x1FF) == 0x1FF && lower + w < lower) {
+        __uint128_t low_product = (__uint128_t)w * json_pow5_table[index + 1];
+        uint64_t low_low = (uint64_t)low_product;
+        uint64_t middle = lower + (uint64_t)(low_product >> 64);
+        if (middle < lower) upper++;
+        if (middle + 1 == 0 && (upper & 0x1FF) == 0x1FF && low_low + w < low_low) return false;
+        lower = middle;
+    }
+
+    uint64_t upper_bit = upper >> 63;
+    uint64_t mantissa = upper >> (upper_bit + 9);
+    lz += (int)(1 ^ upper_bit);
+
+    // 恰好位于两个可表示值中间时无法判断舍入方向
+    if ((upper & 0x1FF) == 0x1FF || ((upper & 0x1FF) == 0 && (mantissa & 3) == 1)) return false;
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (1ULL << 53)) {
+        mantissa = 1ULL << 52;
+        lz--;
+    }
+    mantissa &= ~(1ULL << 52);
+
+    // floor(q * log2(10)) + 1024 + 63
+    int64_t real_exponent = (((152170 + 65536) * q) >> 16) + 1024 + 63 - lz;
+    if (real_exponent < 1 || real_exponent > 2046) return false;
+
+    uint64_t bits = mantissa | ((uint64_t)real_exponent << 52) | ((uint64_t)negative << 63);
+    memcpy(out, &bits, sizeof(double));
+    return true;
+}
+
+// ---------- 公开给库内部的接口 ----------
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 解析数字：整数快速路径 -> Clinger快速路径 -> Eisel-Lemire -> strtod
+size_t json_number_parse(const char* json, size_t len, JsonNumber* out) {
+    size_t pos = 0;
+    bool negative = false;
+    if (pos < len && json[pos] == '-') {
+        negative = true;
+        pos++;
+    }
+    if (pos >= len || !is_digit(json[pos])) return 0;
+
+    // 最多累积19位有效数字，不会溢出；更多的数字只记录是否非零
+    uint64_t mantissa = 0;
+    int64_t exponent = 0;
+    int digits = 0;
+    bool truncated = false;
+
+    size_t int_start = pos;
+    if (json[pos] == '0') {
+        pos++;  // JSON不允许前导零
+    } else {
+        while (pos < len && is_digit(json[pos])) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(json[pos] - '0');
+                digits++;
+            } else {
+                exponent++;
+                if (json[pos] != '0') truncated = true;
+            }
+            pos++;
+        }
+    }
+    size_t int_digits = pos - int_start;
+
+    bool is_integer = true;
+    if (pos < len && json[pos] == '.') {
+        is_integer = false;
+        pos++;
+        size_t frac_start = pos;
+        while (pos < len && is_digit(json[pos])) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (uint64_t)(json[pos] - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            } else if (json[pos] != '0') {
+                truncated = true;
+            }
+            pos++;
+        }
+        if (pos == frac_start) return 0;
+    }
+
+    if (pos < len && (json[pos] == 'e' || json[pos] == 'E')) {
+        is_integer = false;
+        pos++;
+        bool exp_negative = false;
+        if (pos < len && (json[pos] == '+' || json[pos] == '-')) {
+            exp_negative = json[pos] == '-';
+            pos++;
+        }
+        if (pos >= len || !is_digit(json[pos])) return 0;
+        int64_t exp_value = 0;
+        while (pos < len && is_digit(json[pos])) {
+            if (exp_value < 100000) exp_value = exp_value * 10 + (json[pos] - '0');
+            pos++;
+        }
+        exponent += exp_negative ? -exp_value : exp_value;
+    }
+
+    // 整数快速路径：64位范围内的整数保持精确值（-0除外）
+    if (is_integer && !(negative && mantissa == 0)) {
+        if (int_digits <= 19) {
+            if (negative && mantissa <= (uint64_t)INT64_MAX + 1) {
+                out->kind = JSON_NUMBER_INT64;
+                out->value.i = (int64_t)(0 - mantissa);
+                return pos;
+            }
+            if (!negative) {
+                out->kind = mantissa <= (uint64_t)INT64_MAX ? JSON_NUMBER_INT64 : JSON_NUMBER_UINT64;
+                out->value.u = mantissa;
+                return pos;
+            }
+        } else if (int_digits == 20 && !negative) {
+            uint64_t last = (uint64_t)(json[pos - 1] - '0');
+            if (mantissa <= (UINT64_MAX - last) / 10) {
+                out->kind = JSON_NUMBER_UINT64;
+                out->value.u = mantissa * 10 + last;
+                return pos;
+            }
+        }
+    }
+
+    out->kind = JSON_NUMBER_DOUBLE;
+    if (mantissa == 0) {
+        out->value.d = negative ? -0.0 : 0.0;
+        return pos;
+    }
+
+    // Clinger快速路径：尾数和10的幂都能精确表示，一次乘除即正确舍入
+    if (!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        double d = (double)mantissa;
+        d = exponent < 0 ? d / exact_pow10[-exponent] : d * exact_pow10[exponent];
+        out->value.d = negative ? -d : d;
+        return pos;
+    }
+
+    // 截断了有效数字时，真实值位于w和w+1之间，两端舍入结果相同才可采用
+    double d;
+    if (eisel_lemire(exponent, mantissa, negative, &d)) {
+        double upper;
+        if (!truncated || (eisel_lemire(exponent, mantissa + 1, negative, &upper) && upper == d)) {
+            out->value.d = d;
+            return pos;
+        }
+    }
+
+    if (!fallback_strtod(json, pos, &out->value.d)) return 0;
+    return pos;
+}
+
+// 转换为最接近的double
+double json_number_to_double(const JsonNumber* number) {
+    switch (number->kind) {
+        case JSON_NUMBER_INT64: return (double)number->value.i;
+        case JSON_NUMBER_UINT64: return (double)number->value.u;
+        default: return number->value.d;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef JSON_NUMBER_H
+#define JSON_NUMBER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 库内部使用的数字解析，不依赖区域设置
+
+// 数字的精确类别
+typedef enum {
+    JSON_NUMBER_DOUBLE,     // 带小数或指数，或超出64位整数范围
+    JSON_NUMBER_INT64,      // 可用int64_t精确表示的整数
+    JSON_NUMBER_UINT64      // 超出int64_t但可用uint64_t精确表示的整数
+} JsonNumberKind;
+
+typedef struct {
+    JsonNumberKind kind;
+    union {
+        double d;
+        int64_t i;
+        uint64_t u;
+    } value;
+} JsonNumber;
+
+// 按JSON语法解析json[0, len)开头的数字，返回消耗的字节数，格式无效时返回0
+size_t json_number_parse(const char* json, size_t len, JsonNumber* out);
+
+// 转换为最接近的double
+double json_number_to_double(const JsonNumber* number);
+
+#endif // JSON_NUMBER_H
@@ -0,0 +1,262 @@
+#include "json_parallel.h"
+#include "json_internal.h"
+#include "json_simd.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// 一块连续的数组元素：[start, end)，块与块之间以第一层的逗号分隔
+typedef struct {
+    size_t start;
+    size_t end;
+    JsonValue** elements;   // 位于解析该块的线程的内存池中
+    size_t count;
+    JsonError error;        // 解析失败时的错误，成功时code为JSON_ERROR_NONE
+} ParallelChunk;
+
+typedef struct ParallelJob ParallelJob;
+
+// 工作线程：各自持有内存池，从共用的计数器领取块
+typedef struct {
+    JsonArena* arena;
+    ParallelJob* job;
+} ParallelWorker;
+
+struct ParallelJob {
+    const char* json;
+    size_t len;
+    unsigned flags;
+    ParallelChunk* chunks;
+    size_t chunk_count;
+    _Alignas(64) atomic_size_t next;
+};
+
+// 用SIMD扫描一遍数组，在第一层逗号处每隔chunk_size字节切一块；
+// 只定位括号和逗号，不检查语法，语法由各块解析时检查。
+// end接收数组结束括号之后的位置，数组不完整时为0；内存不足时返回false
+static bool split_chunks(ParallelJob* job, size_t root_pos, size_t chunk_size, size_t* end) {
+    size_t max_splits = job->len / chunk_size + 1;
+    size_t* splits = (size_t*)json_malloc(NULL, sizeof(size_t) * max_splits);
+    job->chunks = (ParallelChunk*)json_calloc(NULL, max_splits + 1, sizeof(ParallelChunk));
+    if (!splits || !job->chunks) {
+        json_free(NULL, splits);
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+
+    size_t split_count = 0;
+    *end = json_simd_split_array(job->json, root_pos, job->len, chunk_size,
+                                 splits, max_splits, &split_count);
+    if (*end == 0 || job->json[*end - 1] != ']') {
+        *end = 0;
+        json_free(NULL, splits);
+        return true;
+    }
+
+    size_t start = root_pos + 1;
+    for (size_t i = 0; i < split_count; i++) {
+        job->chunks[i].start = start;
+        job->chunks[i].end = splits[i];
+        start = splits[i] + 1;
+    }
+    job->chunks[split_count].start = start;
+    job->chunks[split_count].end = *end - 1;
+    job->chunk_count = split_count + 1;
+    json_free(NULL, splits);
+    return true;
+}
+
+// 解析一块：元素之间以逗号分隔；只有整个数组只有一块时才允许为空
+static void parse_chunk(ParallelWorker* worker, ParallelChunk* chunk, bool sole) {
+    ParallelJob* job = worker->job;
+    JsonParser* parser = json_parser_create_n(job->json, chunk->end);
+    if (!parser) {
+        chunk->error = json_get_last_error();
+        return;
+    }
+    parser->pos = json_simd_skip_whitespace(job->json, chunk->start, chunk->end);
+    parser->arena = worker->arena;
+    parser->flags = job->flags;
+    if (sole && parser->pos >= chunk->end) {
+        json_parser_free(parser);
+        return;
+    }
+
+    size_t capacity = 64;
+    chunk->elements = (JsonValue**)json_arena_alloc(worker->arena, sizeof(JsonValue*) * capacity);
+    if (!chunk->elements) goto oom;
+
+    for (;;) {
+        JsonValue* value = json_parse_value(parser);
+        if (!value) goto fail;
+        if (chunk->count >= capacity) {
+            JsonValue** new_elements = (JsonValue**)json_arena_realloc(worker->arena, chunk->elements,
+                                                                       sizeof(JsonValue*) * capacity,
+                                                                       sizeof(JsonValue*) * capacity * 2);
+            if (!new_elements) goto oom;
+            chunk->elements = new_elements;
+            capacity *= 2;
+        }
+        chunk->elements[chunk->count++] = value;
+
+        parser->pos = json_simd_skip_whitespace(job->json, parser->pos, parser->len);
+        if (parser->pos >= chunk->end) break;
+        if (job->json[parser->pos] != ',') {
+            json_parser_set_error(parser, JSON_ERROR_EXPECTED_ARRAY_SEPARATOR, parser->pos);
+            goto fail;
+        }
+        parser->pos++;
+    }
+    json_parser_free(parser);
+    return;
+
+oom:
+    json_parser_set_error(parser, JSON_ERROR_OUT_OF_MEMORY, parser->pos);
+fail:
+    chunk->error = parser->error;
+    json_parser_free(parser);
+}
+
+// 工作线程主循环
+static void* worker_run(void* arg) {
+    ParallelWorker* worker = (ParallelWorker*)arg;
+    ParallelJob* job = worker->job;
+    for (;;) {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->chunk_count) break;
+        parse_chunk(worker, &job->chunks[i], job->chunk_count == 1);
+    }
+    return NULL;
+}
+
+// 按输入顺序合并各块的元素，把各线程的内存池并入文档
+static JsonDocument* join_chunks(ParallelJob* job, ParallelWorker* workers, size_t worker_count) {
+    JsonArena* arena = json_arena_create(0);
+    if (!arena) return NULL;
+
+    size_t total = 0;
+    for (size_t i = 0; i < job->chunk_count; i++) total += job->chunks[i].count;
+
+    JsonDocument* doc = (JsonDocument*)json_arena_alloc(arena, sizeof(JsonDocument));
+    JsonValue* root = (JsonValue*)json_arena_alloc(arena, sizeof(JsonValue));
+    JsonArray* array = (JsonArray*)json_arena_alloc(arena, sizeof(JsonArray));
+    JsonValue** elements = (JsonValue**)json_arena_alloc(arena, sizeof(JsonValue*) * (total ? total : 1));
+    if (!doc || !root || !array || !elements) {
+        json_arena_free(arena);
+        return NULL;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < job->chunk_count; i++) {
+        if (job->chunks[i].count == 0) continue;
+        memcpy(elements + n, job->chunks[i].elements, sizeof(JsonValue*) * job->chunks[i].count);
+        n += job->chunks[i].count;
+    }
+    array->elements = elements;
+    array->size = total;
+    array->capacity = total;
+    memset(root, 0, sizeof(JsonValue));
+    root->type = JSON_ARRAY;
+    root->value.array = array;
+
+    for (size_t w = 0; w < worker_count; w++) json_arena_merge(arena, workers[w].arena);
+
+    doc->arena = arena;
+    doc->root = root;
+    doc->owns_arena = true;
+    doc->mapping = NULL;
+    doc->mapping_size = 0;
+    doc->scratch = NULL;
+    return doc;
+}
+
+// 并行解析顶层数组：调用线程也作为0号工作线程参与解析
+JsonDocument* json_parse_array_parallel(const char* json, size_t len, unsigned flags, size_t threads) {
+    if (!json) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (flags & ~(unsigned)(JSON_PARSE_INT64 | JSON_PARSE_VIEWS)) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return NULL;
+    }
+
+    size_t root_pos = json_simd_skip_whitespace(json, 0, len);
+    if (root_pos >= len || json[root_pos] != '[') return json_parse_into_ex(NULL, json, len, flags);
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (size_t)online : 1;
+    }
+    if (threads == 1) return json_parse_into_ex(NULL, json, len, flags);
+    size_t chunk_size = len / (threads * JSON_PARALLEL_CHUNKS_PER_THREAD);
+    if (chunk_size < JSON_PARALLEL_MIN_CHUNK) chunk_size = JSON_PARALLEL_MIN_CHUNK;
+
+    ParallelJob job;
+    memset(&job, 0, sizeof(job));
+    job.json = json;
+    job.len = len;
+    job.flags = flags;
+    atomic_init(&job.next, 0);
+
+    // 数组不完整或括号不匹配时交给顺序解析报告准确的错误
+    size_t end = 0;
+    if (!split_chunks(&job, root_pos, chunk_size, &end)) {
+        json_free(NULL, job.chunks);
+        return NULL;
+    }
+    if (end == 0) {
+        json_free(NULL, job.chunks);
+        return json_parse_into_ex(NULL, json, len, flags);
+    }
+
+    if (threads > job.chunk_count) threads = job.chunk_count;
+    ParallelWorker* workers = (ParallelWorker*)json_calloc(NULL, threads, sizeof(ParallelWorker));
+    pthread_t* handles = (pthread_t*)json_malloc(NULL, sizeof(pthread_t) * threads);
+    size_t worker_count = 0;
+    size_t started = 0;
+    JsonDocument* doc = NULL;
+    if (!workers || !handles) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        goto done;
+    }
+    for (; worker_count < threads; worker_count++) {
+        workers[worker_count].job = &job;
+        workers[worker_count].arena = json_arena_create(0);
+        if (!workers[worker_count].arena) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            goto done;
+        }
+    }
+
+    // 线程创建失败时由已启动的线程和调用线程解析剩余的块
+    for (size_t w = 1; w < worker_count; w++) {
+        if (pthread_create(&handles[started], NULL, worker_run, &workers[w]) != 0) break;
+        started++;
+    }
+    worker_run(&workers[0]);
+    for (size_t t = 0; t < started; t++) pthread_join(handles[t], NULL);
+
+    for (size_t i = 0; i < job.chunk_count; i++) {
+        if (job.chunks[i].error.code != JSON_ERROR_NONE) {
+            json_set_error_at(job.chunks[i].error.code, job.chunks[i].error.offset);
+            goto done;
+        }
+    }
+    if (json_simd_skip_whitespace(json, end, len) < len) {
+        json_set_error_at(JSON_ERROR_TRAILING_CHARACTERS, end);
+        goto done;
+    }
+
+    doc = join_chunks(&job, workers, worker_count);
+    if (!doc) json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+
+done:
+    for (size_t w = 0; w < worker_count; w++) json_arena_free(workers[w].arena);
+    json_free(NULL, workers);
+    json_free(NULL, handles);
+    json_free(NULL, job.chunks);
+    return doc;
+}
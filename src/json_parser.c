@@ -1,169 +1,505 @@
 #include "json_parser.h"
+#include "json_internal.h"
+#include "json_number.h"
+#include "json_simd.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
-// 错误消息缓冲区
-static char error_message[256] = {0};
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-// 设置错误消息
-static void set_error(const char* msg) {
-    strncpy(error_message, msg, sizeof(error_message) - 1);
+// 最近一次的错误：每个线程各自一份，多线程同时解析时互不覆盖
+static _Thread_local JsonError last_error;
+
+// 错误码对应的消息
+static const char* const error_messages[JSON_ERROR_COUNT] = {
+    [JSON_ERROR_NONE] = "",
+    [JSON_ERROR_INVALID_ARGUMENT] = "无效的参数",
+    [JSON_ERROR_INVALID_FLAGS] = "无效的解析选项",
+    [JSON_ERROR_OUT_OF_MEMORY] = "内存分配失败",
+    [JSON_ERROR_INVALID_VALUE] = "无效的JSON值",
+    [JSON_ERROR_INVALID_NUMBER] = "无效的数字格式",
+    [JSON_ERROR_INVALID_BOOL] = "无效的布尔值",
+    [JSON_ERROR_INVALID_NULL] = "无效的null值",
+    [JSON_ERROR_EXPECTED_STRING] = "预期字符串应以引号开始",
+    [JSON_ERROR_UNTERMINATED_STRING] = "字符串未正确结束",
+    [JSON_ERROR_EXPECTED_COLON] = "预期':'",
+    [JSON_ERROR_EXPECTED_ARRAY] = "预期数组应以'['开始",
+    [JSON_ERROR_EXPECTED_OBJECT] = "预期对象应以'{'开始",
+    [JSON_ERROR_EXPECTED_ARRAY_SEPARATOR] = "预期','或']'",
+    [JSON_ERROR_EXPECTED_OBJECT_SEPARATOR] = "预期','或'}'",
+    [JSON_ERROR_UNTERMINATED_ARRAY] = "数组未正确结束",
+    [JSON_ERROR_UNTERMINATED_OBJECT] = "对象未正确结束",
+    [JSON_ERROR_TRAILING_CHARACTERS] = "JSON字符串后存在额外字符",
+    [JSON_ERROR_ABORTED] = "解析被回调中止",
+    [JSON_ERROR_NOT_PUSH_PARSER] = "解析器不支持增量输入",
+    [JSON_ERROR_FILE_OPEN] = "无法打开文件",
+    [JSON_ERROR_FILE_READ] = "无法读取文件",
+    [JSON_ERROR_FILE_MAP] = "无法映射文件",
+    [JSON_ERROR_DOCUMENT_TOO_LARGE] = "文档过大",
+    [JSON_ERROR_THREAD_CREATE] = "无法创建线程",
+    [JSON_ERROR_POINTER_START] = "JSON Pointer应以'/'开始",
+    [JSON_ERROR_POINTER_ESCAPE] = "JSON Pointer中的'~'之后应为'0'或'1'",
+    [JSON_ERROR_FILE_WRITE] = "无法写入文件",
+    [JSON_ERROR_SNAPSHOT_FORMAT] = "无效的快照格式",
+    [JSON_ERROR_INVALID_ESCAPE] = "无效的转义序列",
+};
+
+// 记录错误
+void json_set_error(JsonErrorCode code) {
+    json_set_error_at(code, 0);
+}
+
+void json_set_error_at(JsonErrorCode code, size_t offset) {
+    last_error.code = code;
+    last_error.offset = offset;
+}
+
+void json_parser_set_error(JsonParser* parser, JsonErrorCode code, size_t offset) {
+    parser->error.code = code;
+    parser->error.offset = offset;
+    json_set_error_at(code, offset);
+}
+
+// 在解析器当前位置记录错误
+static void parser_error(JsonParser* parser, JsonErrorCode code) {
+    json_parser_set_error(parser, code, parser->pos);
 }
 
 // 获取错误消息
 const char* json_get_error(void) {
-    return error_message;
+    return error_messages[last_error.code];
+}
+
+JsonError json_get_last_error(void) {
+    return last_error;
+}
+
+const char* json_error_message(JsonErrorCode code) {
+    return (unsigned)code < JSON_ERROR_COUNT ? error_messages[code] : "";
+}
+
+JsonError json_parser_get_error(const JsonParser* parser) {
+    JsonError error = parser->error;
+    if (error.code != JSON_ERROR_NONE && !parser->push) json_error_locate(&error, parser->json, parser->len);
+    return error;
+}
+
+// 统计偏移之前的换行数得到行号，列号为距上一个换行的字节数
+void json_error_locate(JsonError* error, const char* json, size_t len) {
+    size_t end = error->offset < len ? error->offset : len;
+    size_t line = 1;
+    size_t line_start = 0;
+    const char* p = json;
+    const char* stop = json + end;
+    while ((p = (const char*)memchr(p, '\n', (size_t)(stop - p))) != NULL) {
+        line++;
+        p++;
+        line_start = (size_t)(p - json);
+    }
+    error->line = line;
+    error->column = error->offset - line_start + 1;
+}
+
+// 初始化解析器状态
+static void parser_init(JsonParser* parser, const char* json, size_t len) {
+    parser->json = json;
+    parser->pos = 0;
+    parser->len = len;
+    parser->arena = NULL;
+    parser->flags = JSON_PARSE_DEFAULT;
+    parser->push = NULL;
+    parser->owns_arena = false;
+    parser->stack = NULL;
+    parser->stack_size = 0;
+    parser->stack_capacity = 0;
+    parser->allocator = NULL;
+    memset(&parser->error, 0, sizeof(parser->error));
 }
 
 // 创建解析器
 JsonParser* json_parser_create(const char* json) {
-    JsonParser* parser = (JsonParser*)malloc(sizeof(JsonParser));
+    return json_parser_create_n(json, strlen(json));
+}
+
+// 创建解析器：只读取json的前len个字节，不要求以'\0'结尾
+JsonParser* json_parser_create_n(const char* json, size_t len) {
+    return json_parser_create_with(json, len, NULL);
+}
+
+// 使用指定的分配器创建解析器
+JsonParser* json_parser_create_with(const char* json, size_t len, const JsonAllocator* allocator) {
+    JsonParser* parser = (JsonParser*)json_malloc(allocator, sizeof(JsonParser));
     if (!parser) {
-        set_error("内存分配失败");
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
-    parser->json = json;
-    parser->pos = 0;
-    parser->len = strlen(json);
+    parser_init(parser, json, len);
+    parser->allocator = allocator;
     return parser;
 }
 
+// 查看当前字符，到达输入末尾时返回'\0'
+static char peek(const JsonParser* parser) {
+    return parser->pos < parser->len ? parser->json[parser->pos] : '\0';
+}
+
+// 检查当前位置是否以指定字面量开始
+static bool match_literal(const JsonParser* parser, const char* literal, size_t len) {
+    return parser->len - parser->pos >= len &&
+           memcmp(parser->json + parser->pos, literal, len) == 0;
+}
+
+// 分配内存：文档模式下从内存池分配
+static void* parser_alloc(JsonParser* parser, size_t size) {
+    return parser->arena ? json_arena_alloc(parser->arena, size) : json_malloc(parser->allocator, size);
+}
+
+// 调整内存大小
+static void* parser_realloc(JsonParser* parser, void* ptr, size_t old_size, size_t new_size) {
+    return parser->arena ? json_arena_realloc(parser->arena, ptr, old_size, new_size)
+                         : json_realloc(parser->allocator, ptr, new_size);
+}
+
+// 释放内存：文档模式下由内存池统一释放
+static void parser_free(JsonParser* parser, void* ptr) {
+    if (!parser->arena) json_free(parser->allocator, ptr);
+}
+
 // 跳过空白字符
 static void skip_whitespace(JsonParser* parser) {
-    while (parser->pos < parser->len && 
-           (parser->json[parser->pos] == ' ' || 
-            parser->json[parser->pos] == '\n' || 
-            parser->json[parser->pos] == '\r' || 
-            parser->json[parser->pos] == '\t')) {
-        parser->pos++;
+    parser->pos = json_simd_skip_whitespace(parser->json, parser->pos, parser->len);
+}
+
+// 读取4位十六进制数，含非十六进制字符时返回-1
+static int32_t parse_hex4(const char* p) {
+    int32_t value = 0;
+    for (int k = 0; k < 4; k++) {
+        char c = p[k];
+        int32_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else return -1;
+        value = value * 16 + digit;
     }
+    return value;
 }
 
-// 解析字符串
-char* json_parse_string(JsonParser* parser) {
-    if (parser->json[parser->pos] != '"') {
-        set_error("预期字符串应以引号开始");
-        return NULL;
+// 把码点编码为UTF-8，返回写入的字节数
+static size_t encode_utf8(char* dst, uint32_t cp) {
+    if (cp < 0x80) {
+        dst[0] = (char)cp;
+        return 1;
     }
-    parser->pos++;
+    if (cp < 0x800) {
+        dst[0] = (char)(0xC0 | (cp >> 6));
+        dst[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dst[0] = (char)(0xE0 | (cp >> 12));
+        dst[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = (char)(0xF0 | (cp >> 18));
+    dst[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
 
-    size_t start = parser->pos;
-    size_t len = 0;
-    bool escaped = false;
+// 解码\uXXXX（next指向反斜杠），代理对合并为一个码点；返回消耗的输入字节数，无效时返回0
+static size_t unescape_unicode(const char* src, size_t next, size_t n, uint32_t* cp) {
+    if (n - next < 6) return 0;
+    int32_t unit = parse_hex4(src + next + 2);
+    if (unit < 0) return 0;
+    if (unit < 0xD800 || unit > 0xDFFF) {
+        *cp = (uint32_t)unit;
+        return 6;
+    }
+    // 高代理项之后必须紧跟低代理项，单独的代理项无法编码为UTF-8
+    if (unit > 0xDBFF || n - next < 12 || src[next + 6] != '\\' || src[next + 7] != 'u') return 0;
+    int32_t low = parse_hex4(src + next + 8);
+    if (low < 0xDC00 || low > 0xDFFF) return 0;
+    *cp = 0x10000 + (((uint32_t)unit - 0xD800) << 10) + ((uint32_t)low - 0xDC00);
+    return 12;
+}
 
-    while (parser->pos < parser->len) {
-        char c = parser->json[parser->pos];
-        if (escaped) {
-            escaped = false;
-            len++;
-        } else if (c == '\\') {
-            escaped = true;
-        } else if (c == '"') {
-            break;
-        } else {
-            len++;
+// 反转义src中的n个字节并写入dst，返回写入的字节数；转义无效时返回JSON_UNESCAPE_INVALID，
+// error_pos接收该转义的反斜杠在src中的偏移。\uXXXX编码为UTF-8后不超过6个字节，
+// 因此输出不会比输入长，dst可以与src相同（原地解码）
+size_t json_unescape_string(char* dst, const char* src, size_t n, size_t* error_pos) {
+    size_t i = 0, j = 0;
+    while (i < n) {
+        // 整段复制两个转义之间的普通字符
+        size_t next = json_simd_find_quote_or_backslash(src, i, n);
+        if (dst + j != src + i) memmove(dst + j, src + i, next - i);
+        j += next - i;
+        if (next >= n) break;
+
+        size_t consumed = 2;
+        char c = next + 1 < n ? src[next + 1] : '\0';
+        switch (c) {
+            case 'n': dst[j++] = '\n'; break;
+            case 'r': dst[j++] = '\r'; break;
+            case 't': dst[j++] = '\t'; break;
+            case 'b': dst[j++] = '\b'; break;
+            case 'f': dst[j++] = '\f'; break;
+            case '\\': dst[j++] = '\\'; break;
+            case '"': dst[j++] = '"'; break;
+            case '/': dst[j++] = '/'; break;
+            case 'u': {
+                uint32_t cp;
+                consumed = unescape_unicode(src, next, n, &cp);
+                if (consumed == 0) {
+                    if (error_pos) *error_pos = next;
+                    return JSON_UNESCAPE_INVALID;
+                }
+                j += encode_utf8(dst + j, cp);
+                break;
+            }
+            default:
+                if (error_pos) *error_pos = next;
+                return JSON_UNESCAPE_INVALID;
         }
-        parser->pos++;
+        i = next + consumed;
     }
+    return j;
+}
 
-    if (parser->pos >= parser->len) {
-        set_error("字符串未正确结束");
+// 解析字符串并返回其长度。原地模式下字符串直接指向输入缓冲区，不分配内存
+static char* parse_string(JsonParser* parser, size_t* length) {
+    if (peek(parser) != '"') {
+        parser_error(parser, JSON_ERROR_EXPECTED_STRING);
         return NULL;
     }
+    parser->pos++;
+
+    // 向量化查找结束引号，同时记录是否存在转义
+    size_t start = parser->pos;
+    size_t end = json_simd_find_quote_or_backslash(parser->json, start, parser->len);
+    bool has_escape = false;
+    while (end < parser->len && parser->json[end] == '\\') {
+        has_escape = true;
+        end += 2;
+        if (end >= parser->len) break;
+        end = json_simd_find_quote_or_backslash(parser->json, end, parser->len);
+    }
 
-    char* str = (char*)malloc(len + 1);
-    if (!str) {
-        set_error("内存分配失败");
+    if (end >= parser->len) {
+        parser->pos = parser->len;
+        parser_error(parser, JSON_ERROR_UNTERMINATED_STRING);
         return NULL;
     }
 
-    size_t j = 0;
-    escaped = false;
-    for (size_t i = start; i < parser->pos; i++) {
-        if (escaped) {
-            switch (parser->json[i]) {
-                case 'n': str[j++] = '\n'; break;
-                case 'r': str[j++] = '\r'; break;
-                case 't': str[j++] = '\t'; break;
-                case '\\': str[j++] = '\\'; break;
-                case '"': str[j++] = '"'; break;
-                default: str[j++] = parser->json[i];
-            }
-            escaped = false;
-        } else if (parser->json[i] == '\\') {
-            escaped = true;
+    // 反转义后的长度不会超过原始长度
+    size_t raw_len = end - start;
+    size_t len = raw_len;
+    size_t bad = 0;
+    char* str;
+    if (parser->flags & JSON_PARSE_INSITU) {
+        // 结束引号已被消费，可以直接覆盖为字符串结束符
+        str = (char*)parser->json + start;
+        if (has_escape) len = json_unescape_string(str, str, raw_len, &bad);
+    } else if ((parser->flags & JSON_PARSE_VIEWS) && !has_escape) {
+        // 只读视图不写入结束符
+        parser->pos = end + 1;
+        *length = len;
+        return (char*)parser->json + start;
+    } else {
+        str = (char*)parser_alloc(parser, raw_len + 1);
+        if (!str) {
+            parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        if (has_escape) {
+            len = json_unescape_string(str, parser->json + start, raw_len, &bad);
         } else {
-            str[j++] = parser->json[i];
+            memcpy(str, parser->json + start, raw_len);
         }
     }
-    str[j] = '\0';
-    parser->pos++;
+    if (len == JSON_UNESCAPE_INVALID) {
+        parser_free(parser, str == parser->json + start ? NULL : str);
+        parser->pos = start + bad;
+        parser_error(parser, JSON_ERROR_INVALID_ESCAPE);
+        return NULL;
+    }
+    str[len] = '\0';
+    parser->pos = end + 1;
+    *length = len;
     return str;
 }
 
-// 解析数字
-double json_parse_number(JsonParser* parser) {
-    char* endptr;
-    double num = strtod(parser->json + parser->pos, &endptr);
-    if (endptr == parser->json + parser->pos) {
-        set_error("无效的数字格式");
-        return 0;
+// 解析字符串
+char* json_parse_string(JsonParser* parser) {
+    size_t length;
+    return parse_string(parser, &length);
+}
+
+// 解析数字：手写解析，不依赖区域设置，且不会越过len读取
+static bool parse_number(JsonParser* parser, JsonNumber* number) {
+    size_t consumed = json_number_parse(parser->json + parser->pos, parser->len - parser->pos, number);
+    if (consumed == 0) {
+        parser_error(parser, JSON_ERROR_INVALID_NUMBER);
+        return false;
     }
-    parser->pos = endptr - parser->json;
-    return num;
+    parser->pos += consumed;
+    return true;
+}
+
+double json_parse_number(JsonParser* parser) {
+    JsonNumber number;
+    if (!parse_number(parser, &number)) return 0;
+    return json_number_to_double(&number);
 }
 
 // 解析布尔值
 bool json_parse_bool(JsonParser* parser) {
-    if (strncmp(parser->json + parser->pos, "true", 4) == 0) {
+    if (match_literal(parser, "true", 4)) {
         parser->pos += 4;
         return true;
-    } else if (strncmp(parser->json + parser->pos, "false", 5) == 0) {
+    } else if (match_literal(parser, "false", 5)) {
         parser->pos += 5;
         return false;
     }
-    set_error("无效的布尔值");
+    parser_error(parser, JSON_ERROR_INVALID_BOOL);
     return false;
 }
 
 // 解析null
 void json_parse_null(JsonParser* parser) {
-    if (strncmp(parser->json + parser->pos, "null", 4) == 0) {
+    if (match_literal(parser, "null", 4)) {
         parser->pos += 4;
         return;
     }
-    set_error("无效的null值");
+    parser_error(parser, JSON_ERROR_INVALID_NULL);
 }
 
 // 前向声明
 JsonValue* json_parse_value(JsonParser* parser);
 
+// 在暂存栈顶部预留size字节，空间不足时倍增；嵌套容器可能触发扩容，因此只保存偏移
+static void* stack_push(JsonParser* parser, size_t size) {
+    if (parser->stack_capacity - parser->stack_size < size) {
+        size_t capacity = parser->stack_capacity ? parser->stack_capacity * 2 : JSON_STACK_INITIAL_SIZE;
+        while (capacity - parser->stack_size < size) capacity *= 2;
+        char* stack = (char*)json_realloc(parser->allocator, parser->stack, capacity);
+        if (!stack) {
+            parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        parser->stack = stack;
+        parser->stack_capacity = capacity;
+    }
+    void* top = parser->stack + parser->stack_size;
+    parser->stack_size += size;
+    return top;
+}
+
+// 把暂存栈中base之上的内容按实际大小复制到内存池并出栈；空容器不分配
+static void* stack_pop(JsonParser* parser, size_t base, size_t* count, size_t item_size) {
+    size_t size = parser->stack_size - base;
+    *count = size / item_size;
+    parser->stack_size = base;
+    if (size == 0) return NULL;
+
+    void* items = json_arena_alloc(parser->arena, size);
+    if (!items) {
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    memcpy(items, parser->stack + base, size);
+    return items;
+}
+
+// 出错时释放未完成的数组和对象，文档模式下由内存池统一释放
+static void array_discard(JsonParser* parser, JsonArray* array) {
+    if (parser->arena) return;
+    for (size_t i = 0; i < array->size; i++) json_value_free_with(array->elements[i], parser->allocator);
+    json_free(parser->allocator, array->elements);
+    json_free(parser->allocator, array);
+}
+
+static void object_discard(JsonParser* parser, JsonObject* object) {
+    if (parser->arena) return;
+    for (size_t i = 0; i < object->size; i++) {
+        json_free(parser->allocator, object->pairs[i].key);
+        json_value_free_with(object->pairs[i].value, parser->allocator);
+    }
+    json_free(parser->allocator, object->pairs);
+    json_free(parser->allocator, object->index);
+    json_free(parser->allocator, object);
+}
+
+// 使用暂存栈解析数组元素，结束时一次分配恰好大小的元素数组
+static bool parse_array_stacked(JsonParser* parser, JsonArray* array) {
+    size_t base = parser->stack_size;
+    skip_whitespace(parser);
+    if (peek(parser) != ']') {
+        while (parser->pos < parser->len) {
+            JsonValue* value = json_parse_value(parser);
+            JsonValue** slot = value ? (JsonValue**)stack_push(parser, sizeof(JsonValue*)) : NULL;
+            if (!slot) {
+                parser->stack_size = base;
+                return false;
+            }
+            *slot = value;
+
+            skip_whitespace(parser);
+            if (peek(parser) == ']') break;
+            if (peek(parser) != ',') {
+                parser_error(parser, JSON_ERROR_EXPECTED_ARRAY_SEPARATOR);
+                parser->stack_size = base;
+                return false;
+            }
+            parser->pos++;
+            skip_whitespace(parser);
+        }
+        if (parser->pos >= parser->len) {
+            parser_error(parser, JSON_ERROR_UNTERMINATED_ARRAY);
+            parser->stack_size = base;
+            return false;
+        }
+    }
+    parser->pos++;
+
+    array->elements = (JsonValue**)stack_pop(parser, base, &array->size, sizeof(JsonValue*));
+    array->capacity = array->size;
+    return array->elements || array->size == 0;
+}
+
 // 解析数组
 JsonArray* json_parse_array(JsonParser* parser) {
-    if (parser->json[parser->pos] != '[') {
-        set_error("预期数组应以'['开始");
+    if (peek(parser) != '[') {
+        parser_error(parser, JSON_ERROR_EXPECTED_ARRAY);
         return NULL;
     }
     parser->pos++;
 
-    JsonArray* array = (JsonArray*)malloc(sizeof(JsonArray));
+    JsonArray* array = (JsonArray*)parser_alloc(parser, sizeof(JsonArray));
     if (!array) {
-        set_error("内存分配失败");
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
+    if (parser->stack) return parse_array_stacked(parser, array) ? array : NULL;
     array->capacity = 8;
     array->size = 0;
-    array->elements = (JsonValue**)malloc(sizeof(JsonValue*) * array->capacity);
+    array->elements = (JsonValue**)parser_alloc(parser, sizeof(JsonValue*) * array->capacity);
     if (!array->elements) {
-        free(array);
-        set_error("内存分配失败");
+        parser_free(parser, array);
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
 
     skip_whitespace(parser);
-    if (parser->json[parser->pos] == ']') {
+    if (peek(parser) == ']') {
         parser->pos++;
         return array;
     }
@@ -172,15 +508,19 @@ JsonArray* json_parse_array(JsonParser* parser) {
         JsonValue* value = json_parse_value(parser);
         if (!value) {
             // 错误信息已在parse_value中设置
+            array_discard(parser, array);
             return NULL;
         }
 
         if (array->size >= array->capacity) {
             size_t new_capacity = array->capacity * 2;
-            JsonValue** new_elements = (JsonValue**)realloc(array->elements, 
-                                                          sizeof(JsonValue*) * new_capacity);
+            JsonValue** new_elements = (JsonValue**)parser_realloc(parser, array->elements,
+                                                                 sizeof(JsonValue*) * array->capacity,
+                                                                 sizeof(JsonValue*) * new_capacity);
             if (!new_elements) {
-                set_error("内存分配失败");
+                if (!parser->arena) json_value_free_with(value, parser->allocator);
+                array_discard(parser, array);
+                parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
                 return NULL;
             }
             array->elements = new_elements;
@@ -190,61 +530,179 @@ JsonArray* json_parse_array(JsonParser* parser) {
         array->elements[array->size++] = value;
 
         skip_whitespace(parser);
-        if (parser->json[parser->pos] == ']') {
+        if (peek(parser) == ']') {
             parser->pos++;
             return array;
         }
 
-        if (parser->json[parser->pos] != ',') {
-            set_error("预期','或']'");
+        if (peek(parser) != ',') {
+            parser_error(parser, JSON_ERROR_EXPECTED_ARRAY_SEPARATOR);
+            array_discard(parser, array);
             return NULL;
         }
         parser->pos++;
         skip_whitespace(parser);
     }
 
-    set_error("数组未正确结束");
+    parser_error(parser, JSON_ERROR_UNTERMINATED_ARRAY);
+    array_discard(parser, array);
     return NULL;
 }
 
+// 计算键的哈希值：每次处理8字节，键刚解析完仍在缓存中
+uint32_t json_hash_key(const char* key, size_t len) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ (len * 0xFF51AFD7ED558CCDULL);
+    while (len >= 8) {
+        uint64_t word;
+        memcpy(&word, key, 8);
+        h = (h ^ word) * 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 29;
+        key += 8;
+        len -= 8;
+    }
+    if (len > 0) {
+        uint64_t word = 0;
+        memcpy(&word, key, len);
+        h = (h ^ word) * 0xC4CEB9FE1A85EC53ULL;
+    }
+    h ^= h >> 32;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 29;
+    return (uint32_t)h;
+}
+
+// 槽位数取不小于成员数两倍的2的幂，保证装载因子不超过0.5
+size_t json_object_index_slots(size_t size) {
+    if (size < JSON_OBJECT_INDEX_MIN_SIZE) return 0;
+    size_t slots = 1;
+    while (slots < size * 2) slots <<= 1;
+    return slots;
+}
+
+// 按成员顺序插入，线性探测保证重复的键先找到靠前的成员
+void json_object_fill_index(JsonObject* object, uint32_t* slots, size_t slot_count) {
+    size_t mask = slot_count - 1;
+    for (size_t i = 0; i < object->size; i++) {
+        size_t slot = object->pairs[i].hash & mask;
+        while (slots[slot]) slot = (slot + 1) & mask;
+        slots[slot] = (uint32_t)(i + 1);
+    }
+    object->index = slots;
+    object->index_mask = mask;
+}
+
+// 对象解析完成：成员较多时建立哈希索引
+static bool object_finish(JsonParser* parser, JsonObject* object) {
+    size_t slot_count = json_object_index_slots(object->size);
+    if (slot_count == 0) return true;
+
+    uint32_t* slots = (uint32_t*)parser_alloc(parser, sizeof(uint32_t) * slot_count);
+    if (!slots) {
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    memset(slots, 0, sizeof(uint32_t) * slot_count);
+    json_object_fill_index(object, slots, slot_count);
+    return true;
+}
+
+// 使用暂存栈解析对象成员，结束时一次分配恰好大小的成员数组
+static bool parse_object_stacked(JsonParser* parser, JsonObject* object) {
+    size_t base = parser->stack_size;
+    skip_whitespace(parser);
+    if (peek(parser) != '}') {
+        while (parser->pos < parser->len) {
+            skip_whitespace(parser);
+            size_t key_length;
+            char* key = parse_string(parser, &key_length);
+            if (!key) goto fail;
+
+            skip_whitespace(parser);
+            if (peek(parser) != ':') {
+                parser_error(parser, JSON_ERROR_EXPECTED_COLON);
+                goto fail;
+            }
+            parser->pos++;
+
+            skip_whitespace(parser);
+            JsonValue* value = json_parse_value(parser);
+            if (!value) goto fail;
+            JsonKeyValue* pair = (JsonKeyValue*)stack_push(parser, sizeof(JsonKeyValue));
+            if (!pair) goto fail;
+            pair->key = key;
+            pair->key_length = key_length;
+            pair->hash = json_hash_key(key, key_length);
+            pair->value = value;
+
+            skip_whitespace(parser);
+            if (peek(parser) == '}') break;
+            if (peek(parser) != ',') {
+                parser_error(parser, JSON_ERROR_EXPECTED_OBJECT_SEPARATOR);
+                goto fail;
+            }
+            parser->pos++;
+        }
+        if (parser->pos >= parser->len) {
+            parser_error(parser, JSON_ERROR_UNTERMINATED_OBJECT);
+            goto fail;
+        }
+    }
+    parser->pos++;
+
+    object->pairs = (JsonKeyValue*)stack_pop(parser, base, &object->size, sizeof(JsonKeyValue));
+    object->capacity = object->size;
+    if (!object->pairs && object->size > 0) return false;
+    return object_finish(parser, object);
+
+fail:
+    parser->stack_size = base;
+    return false;
+}
+
 // 解析对象
 JsonObject* json_parse_object(JsonParser* parser) {
-    if (parser->json[parser->pos] != '{') {
-        set_error("预期对象应以'{'开始");
+    if (peek(parser) != '{') {
+        parser_error(parser, JSON_ERROR_EXPECTED_OBJECT);
         return NULL;
     }
     parser->pos++;
 
-    JsonObject* object = (JsonObject*)malloc(sizeof(JsonObject));
+    JsonObject* object = (JsonObject*)parser_alloc(parser, sizeof(JsonObject));
     if (!object) {
-        set_error("内存分配失败");
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
     memset(object, 0, sizeof(JsonObject));
+    if (parser->stack) return parse_object_stacked(parser, object) ? object : NULL;
     object->capacity = 8;
-    object->pairs = (JsonKeyValue*)malloc(sizeof(JsonKeyValue) * object->capacity);
+    object->pairs = (JsonKeyValue*)parser_alloc(parser, sizeof(JsonKeyValue) * object->capacity);
     if (!object->pairs) {
-        free(object);
-        set_error("内存分配失败");
+        parser_free(parser, object);
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
     memset(object->pairs, 0, sizeof(JsonKeyValue) * object->capacity);
 
     skip_whitespace(parser);
-    if (parser->json[parser->pos] == '}') {
+    if (peek(parser) == '}') {
         parser->pos++;
         return object;
     }
 
     while (parser->pos < parser->len) {
         skip_whitespace(parser);
-        char* key = json_parse_string(parser);
-        if (!key) return NULL;
+        size_t key_length;
+        char* key = parse_string(parser, &key_length);
+        if (!key) {
+            object_discard(parser, object);
+            return NULL;
+        }
 
         skip_whitespace(parser);
-        if (parser->json[parser->pos] != ':') {
-            set_error("预期':'");
-            free(key);
+        if (peek(parser) != ':') {
+            parser_error(parser, JSON_ERROR_EXPECTED_COLON);
+            parser_free(parser, key);
+            object_discard(parser, object);
             return NULL;
         }
         parser->pos++;
@@ -252,18 +710,21 @@ JsonObject* json_parse_object(JsonParser* parser) {
         skip_whitespace(parser);
         JsonValue* value = json_parse_value(parser);
         if (!value) {
-            free(key);
+            parser_free(parser, key);
+            object_discard(parser, object);
             return NULL;
         }
 
         if (object->size >= object->capacity) {
             size_t new_capacity = object->capacity * 2;
-            JsonKeyValue* new_pairs = (JsonKeyValue*)realloc(object->pairs, 
-                                                           sizeof(JsonKeyValue) * new_capacity);
+            JsonKeyValue* new_pairs = (JsonKeyValue*)parser_realloc(parser, object->pairs,
+                                                                  sizeof(JsonKeyValue) * object->capacity,
+                                                                  sizeof(JsonKeyValue) * new_capacity);
             if (!new_pairs) {
-                free(key);
-                json_value_free(value);
-                set_error("内存分配失败");
+                parser_free(parser, key);
+                if (!parser->arena) json_value_free_with(value, parser->allocator);
+                object_discard(parser, object);
+                parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
                 return NULL;
             }
             memset(new_pairs + object->capacity, 0, sizeof(JsonKeyValue) * (new_capacity - object->capacity));
@@ -271,26 +732,33 @@ JsonObject* json_parse_object(JsonParser* parser) {
             object->capacity = new_capacity;
         }
 
-        // 确保键值对正确存储
-        object->pairs[object->size].key = strdup(key);
+        // 键的所有权直接转移给键值对，无需再复制
+        object->pairs[object->size].key = key;
+        object->pairs[object->size].key_length = key_length;
+        object->pairs[object->size].hash = json_hash_key(key, key_length);
         object->pairs[object->size].value = value;
         object->size++;
-        free(key);  // 释放原始key，因为我们已经复制了它
 
         skip_whitespace(parser);
-        if (parser->json[parser->pos] == '}') {
+        if (peek(parser) == '}') {
             parser->pos++;
+            if (!object_finish(parser, object)) {
+                object_discard(parser, object);
+                return NULL;
+            }
             return object;
         }
 
-        if (parser->json[parser->pos] != ',') {
-            set_error("预期','或'}'");
+        if (peek(parser) != ',') {
+            parser_error(parser, JSON_ERROR_EXPECTED_OBJECT_SEPARATOR);
+            object_discard(parser, object);
             return NULL;
         }
         parser->pos++;
     }
 
-    set_error("对象未正确结束");
+    parser_error(parser, JSON_ERROR_UNTERMINATED_OBJECT);
+    object_discard(parser, object);
     return NULL;
 }
 
@@ -298,19 +766,21 @@ JsonObject* json_parse_object(JsonParser* parser) {
 JsonValue* json_parse_value(JsonParser* parser) {
     skip_whitespace(parser);
 
-    JsonValue* value = (JsonValue*)malloc(sizeof(JsonValue));
+    JsonValue* value = (JsonValue*)parser_alloc(parser, sizeof(JsonValue));
     if (!value) {
-        set_error("内存分配失败");
+        parser_error(parser, JSON_ERROR_OUT_OF_MEMORY);
         return NULL;
     }
 
-    char c = parser->json[parser->pos];
+    // 标量解析失败时位置不会前进
+    size_t start = parser->pos;
+    char c = peek(parser);
     switch (c) {
         case '"':
             value->type = JSON_STRING;
-            value->value.string = json_parse_string(parser);
+            value->value.string = parse_string(parser, &value->length);
             if (!value->value.string) {
-                free(value);
+                parser_free(parser, value);
                 return NULL;
             }
             break;
@@ -319,7 +789,7 @@ JsonValue* json_parse_value(JsonParser* parser) {
             value->type = JSON_OBJECT;
             value->value.object = json_parse_object(parser);
             if (!value->value.object) {
-                free(value);
+                parser_free(parser, value);
                 return NULL;
             }
             break;
@@ -328,7 +798,7 @@ JsonValue* json_parse_value(JsonParser* parser) {
             value->type = JSON_ARRAY;
             value->value.array = json_parse_array(parser);
             if (!value->value.array) {
-                free(value);
+                parser_free(parser, value);
                 return NULL;
             }
             break;
@@ -337,8 +807,8 @@ JsonValue* json_parse_value(JsonParser* parser) {
         case 'f':
             value->type = JSON_BOOL;
             value->value.boolean = json_parse_bool(parser);
-            if (parser->pos >= parser->len) {
-                free(value);
+            if (parser->pos == start) {
+                parser_free(parser, value);
                 return NULL;
             }
             break;
@@ -346,23 +816,29 @@ JsonValue* json_parse_value(JsonParser* parser) {
         case 'n':
             value->type = JSON_NULL;
             json_parse_null(parser);
-            if (parser->pos >= parser->len) {
-                free(value);
+            if (parser->pos == start) {
+                parser_free(parser, value);
                 return NULL;
             }
             break;
 
         default:
-            if (c == '-' || isdigit(c)) {
-                value->type = JSON_NUMBER;
-                value->value.number = json_parse_number(parser);
-                if (parser->pos >= parser->len) {
-                    free(value);
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                JsonNumber number;
+                if (!parse_number(parser, &number)) {
+                    parser_free(parser, value);
                     return NULL;
                 }
+                if ((parser->flags & JSON_PARSE_INT64) && number.kind != JSON_NUMBER_DOUBLE) {
+                    value->type = number.kind == JSON_NUMBER_INT64 ? JSON_INT64 : JSON_UINT64;
+                    value->value.uint64 = number.value.u;
+                } else {
+                    value->type = JSON_NUMBER;
+                    value->value.number = json_number_to_double(&number);
+                }
             } else {
-                set_error("无效的JSON值");
-                free(value);
+                parser_error(parser, JSON_ERROR_INVALID_VALUE);
+                parser_free(parser, value);
                 return NULL;
             }
     }
@@ -372,54 +848,338 @@ JsonValue* json_parse_value(JsonParser* parser) {
 
 // 解析JSON字符串
 JsonValue* json_parse(const char* json) {
-    JsonParser* parser = json_parser_create(json);
+    return json_parse_n(json, strlen(json));
+}
+
+// 解析长度为len的JSON缓冲区，不要求以'\0'结尾
+JsonValue* json_parse_n(const char* json, size_t len) {
+    return json_parse_ex(json, len, JSON_PARSE_DEFAULT);
+}
+
+// 带解析选项的版本；值树由json_value_free逐节点释放，字符串必须自行持有，因此只接受JSON_PARSE_INT64
+JsonValue* json_parse_ex(const char* json, size_t len, unsigned flags) {
+    if (flags & ~(unsigned)JSON_PARSE_INT64) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return NULL;
+    }
+
+    JsonParser* parser = json_parser_create_n(json, len);
     if (!parser) return NULL;
+    parser->flags = flags;
 
     JsonValue* value = json_parse_value(parser);
-    skip_whitespace(parser);
-
-    if (parser->pos < parser->len) {
-        set_error("JSON字符串后存在额外字符");
-        json_value_free(value);
-        value = NULL;
+    if (value) {
+        skip_whitespace(parser);
+        if (parser->pos < parser->len) {
+            parser_error(parser, JSON_ERROR_TRAILING_CHARACTERS);
+            json_value_free(value);
+            value = NULL;
+        }
     }
 
     json_parser_free(parser);
     return value;
 }
 
+// 可复用文档在两次解析之间保留的缓冲区
+struct JsonDocumentScratch {
+    char* stack;            // 容器暂存栈
+    size_t stack_capacity;
+};
+
+// 在文档模式的解析器上解析整个输入，之后不能有多余字符
+static JsonValue* parse_root(JsonParser* parser) {
+    JsonValue* root = json_parse_value(parser);
+    if (root) {
+        skip_whitespace(parser);
+        if (parser->pos < parser->len) {
+            parser_error(parser, JSON_ERROR_TRAILING_CHARACTERS);
+            root = NULL;
+        }
+    }
+    return root;
+}
+
+// 解析到文档：所有分配都来自内存池，释放时无需逐节点遍历
+static JsonDocument* parse_document(JsonArena* arena, const char* json, size_t len, unsigned flags) {
+    bool owns_arena = (arena == NULL);
+    if (owns_arena) {
+        arena = json_arena_create(0);
+        if (!arena) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+    }
+
+    JsonDocument* doc = (JsonDocument*)json_arena_alloc(arena, sizeof(JsonDocument));
+    if (!doc) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        if (owns_arena) json_arena_free(arena);
+        return NULL;
+    }
+    doc->arena = arena;
+    doc->owns_arena = owns_arena;
+    doc->mapping = NULL;
+    doc->mapping_size = 0;
+    doc->scratch = NULL;
+
+    JsonParser parser;
+    parser_init(&parser, json, len);
+    parser.arena = arena;
+    parser.allocator = arena->allocator;
+    parser.flags = flags;
+
+    doc->root = parse_root(&parser);
+
+    if (!doc->root) {
+        if (owns_arena) json_arena_free(arena);
+        return NULL;
+    }
+    return doc;
+}
+
+// 创建可复用文档：文档本身不在内存池中，重置内存池时不受影响
+JsonDocument* json_document_create(void) {
+    return json_document_create_with(NULL);
+}
+
+// 使用指定的分配器创建可复用文档：文档、内存池和解析缓冲区都经由该分配器
+JsonDocument* json_document_create_with(const JsonAllocator* allocator) {
+    JsonDocument* doc = (JsonDocument*)json_calloc(allocator, 1, sizeof(JsonDocument));
+    struct JsonDocumentScratch* scratch =
+        (struct JsonDocumentScratch*)json_calloc(allocator, 1, sizeof(struct JsonDocumentScratch));
+    JsonArena* arena = json_arena_create_with(0, allocator);
+    if (!doc || !scratch || !arena) {
+        json_free(allocator, doc);
+        json_free(allocator, scratch);
+        json_arena_free(arena);
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    doc->arena = arena;
+    doc->owns_arena = true;
+    doc->scratch = scratch;
+    return doc;
+}
+
+// 解析到可复用文档：解析器位于栈上，暂存栈取自文档并在解析后交还
+JsonValue* json_document_parse(JsonDocument* doc, const char* json, size_t len, unsigned flags) {
+    if (!doc || !doc->scratch || !json) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (flags & ~(unsigned)(JSON_PARSE_INSITU | JSON_PARSE_VIEWS | JSON_PARSE_INT64)) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return NULL;
+    }
+    json_document_reset(doc);
+
+    struct JsonDocumentScratch* scratch = doc->scratch;
+    JsonParser parser;
+    parser_init(&parser, json, len);
+    parser.arena = doc->arena;
+    parser.allocator = doc->arena->allocator;
+    parser.flags = flags;
+    if (!scratch->stack) {
+        scratch->stack = (char*)json_malloc(parser.allocator, JSON_STACK_INITIAL_SIZE);
+        if (!scratch->stack) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return NULL;
+        }
+        scratch->stack_capacity = JSON_STACK_INITIAL_SIZE;
+    }
+    parser.stack = scratch->stack;
+    parser.stack_capacity = scratch->stack_capacity;
+
+    doc->root = parse_root(&parser);
+    scratch->stack = parser.stack;
+    scratch->stack_capacity = parser.stack_capacity;
+    return doc->root;
+}
+
+// 重置可复用文档：内存块全部保留，下一次解析依次复用
+void json_document_reset(JsonDocument* doc) {
+    if (!doc || !doc->scratch) return;
+    doc->root = NULL;
+    json_arena_rewind(doc->arena);
+}
+
+// 解析到文档
+JsonDocument* json_parse_into(JsonArena* arena, const char* json) {
+    return parse_document(arena, json, strlen(json), JSON_PARSE_DEFAULT);
+}
+
+JsonDocument* json_parse_into_n(JsonArena* arena, const char* json, size_t len) {
+    return parse_document(arena, json, len, JSON_PARSE_DEFAULT);
+}
+
+// 带解析选项的版本，输入只读，因此不接受JSON_PARSE_INSITU
+JsonDocument* json_parse_into_ex(JsonArena* arena, const char* json, size_t len, unsigned flags) {
+    if (flags & JSON_PARSE_INSITU) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return NULL;
+    }
+    return parse_document(arena, json, len, flags);
+}
+
+// 原地解析到文档：字符串和键直接指向json缓冲区，缓冲区需在文档释放前保持有效
+JsonDocument* json_parse_insitu(JsonArena* arena, char* json) {
+    return parse_document(arena, json, strlen(json), JSON_PARSE_INSITU);
+}
+
+JsonDocument* json_parse_insitu_n(JsonArena* arena, char* json, size_t len) {
+    return parse_document(arena, json, len, JSON_PARSE_INSITU);
+}
+
+// 解除文件映射
+void json_unmap_file(void* mapping, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    json_free(NULL, mapping);
+#else
+    munmap(mapping, size);
+#endif
+}
+
+// 将文件内容映射到内存。不支持mmap的平台读入堆缓冲区
+void* json_map_file(const char* path, unsigned flags, size_t* size) {
+#ifdef _WIN32
+    (void)flags;
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        json_set_error(JSON_ERROR_FILE_OPEN);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* buffer = (char*)json_malloc(NULL, file_size > 0 ? (size_t)file_size : 1);
+    if (!buffer) {
+        fclose(file);
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    *size = fread(buffer, 1, file_size > 0 ? (size_t)file_size : 0, file);
+    fclose(file);
+    return buffer;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        json_set_error(JSON_ERROR_FILE_OPEN);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        json_set_error(JSON_ERROR_FILE_READ);
+        return NULL;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        json_set_error(JSON_ERROR_INVALID_VALUE);
+        return NULL;
+    }
+
+    // 原地模式使用私有可写映射，只有被写入的页才会被复制
+    int prot = (flags & JSON_PARSE_INSITU) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* mapping = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        json_set_error(JSON_ERROR_FILE_MAP);
+        return NULL;
+    }
+
+    madvise(mapping, (size_t)st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+    madvise(mapping, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+    *size = (size_t)st.st_size;
+    return mapping;
+#endif
+}
+
+// 解析文件：直接在文件映射上解析，不再复制到堆缓冲区。
+// 默认字符串复制到文档内存池并立即解除映射；JSON_PARSE_VIEWS或JSON_PARSE_INSITU
+// 模式下字符串引用映射内容，映射在释放文档时解除
+JsonDocument* json_parse_file(const char* path, unsigned flags) {
+    size_t size = 0;
+    void* mapping = json_map_file(path, flags, &size);
+    if (!mapping) return NULL;
+
+    JsonDocument* doc = parse_document(NULL, (const char*)mapping, size, flags);
+    if (!doc || !(flags & (JSON_PARSE_VIEWS | JSON_PARSE_INSITU))) {
+        json_unmap_file(mapping, size);
+        return doc;
+    }
+
+    doc->mapping = mapping;
+    doc->mapping_size = size;
+    return doc;
+}
+
+// 获取文档根节点
+JsonValue* json_document_root(JsonDocument* doc) {
+    return doc ? doc->root : NULL;
+}
+
+// 释放文档：文档自身也位于内存池中，一次释放全部内存；可复用文档另外释放保留的缓冲区
+void json_document_free(JsonDocument* doc) {
+    if (!doc) return;
+    if (doc->mapping) json_unmap_file(doc->mapping, doc->mapping_size);
+    if (doc->scratch) {
+        const JsonAllocator* allocator = doc->arena->allocator;
+        json_free(allocator, doc->scratch->stack);
+        json_free(allocator, doc->scratch);
+        json_arena_free(doc->arena);
+        json_free(allocator, doc);
+        return;
+    }
+    if (doc->owns_arena) json_arena_free(doc->arena);
+}
+
 // 释放解析器
 void json_parser_free(JsonParser* parser) {
-    free(parser);
+    if (!parser) return;
+    json_free(parser->allocator, parser->stack);
+    json_push_state_free(parser->push);
+    if (parser->owns_arena) json_arena_free(parser->arena);
+    json_free(parser->allocator, parser);
 }
 
 // 释放JSON值
 void json_value_free(JsonValue* value) {
+    json_value_free_with(value, NULL);
+}
+
+// 用分配值树时的分配器释放JSON值
+void json_value_free_with(JsonValue* value, const JsonAllocator* allocator) {
     if (!value) return;
 
     switch (value->type) {
         case JSON_STRING:
-            free(value->value.string);
+            json_free(allocator, value->value.string);
             break;
 
         case JSON_ARRAY:
             if (value->value.array) {
                 for (size_t i = 0; i < value->value.array->size; i++) {
-                    json_value_free(value->value.array->elements[i]);
+                    json_value_free_with(value->value.array->elements[i], allocator);
                 }
-                free(value->value.array->elements);
-                free(value->value.array);
+                json_free(allocator, value->value.array->elements);
+                json_free(allocator, value->value.array);
             }
             break;
 
         case JSON_OBJECT:
             if (value->value.object) {
                 for (size_t i = 0; i < value->value.object->size; i++) {
-                    free(value->value.object->pairs[i].key);
-                    json_value_free(value->value.object->pairs[i].value);
+                    json_free(allocator, value->value.object->pairs[i].key);
+                    json_value_free_with(value->value.object->pairs[i].value, allocator);
                 }
-                free(value->value.object->pairs);
-                free(value->value.object);
+                json_free(allocator, value->value.object->pairs);
+                json_free(allocator, value->value.object->index);
+                json_free(allocator, value->value.object);
             }
             break;
 
@@ -427,7 +1187,7 @@ void json_value_free(JsonValue* value) {
             break;
     }
 
-    free(value);
+    json_free(allocator, value);
 }
 
 // 获取值操作函数实现
@@ -435,8 +1195,89 @@ const char* json_value_get_string(JsonValue* value) {
     return (value && value->type == JSON_STRING) ? value->value.string : NULL;
 }
 
+size_t json_value_get_string_length(JsonValue* value) {
+    return (value && value->type == JSON_STRING) ? value->length : 0;
+}
+
+JsonValue* json_object_get(const JsonObject* object, const char* key, size_t key_length) {
+    if (!object || !key) return NULL;
+    return json_object_get_hashed(object, key, key_length, json_hash_key(key, key_length));
+}
+
+// 按键查找：有哈希索引时探测索引，否则线性扫描，都先比较哈希值和长度
+JsonValue* json_object_get_hashed(const JsonObject* object, const char* key, size_t key_length, uint32_t hash) {
+    if (object->index) {
+        size_t slot = hash & object->index_mask;
+        while (object->index[slot]) {
+            const JsonKeyValue* pair = &object->pairs[object->index[slot] - 1];
+            if (pair->hash == hash && pair->key_length == key_length &&
+                memcmp(pair->key, key, key_length) == 0) {
+                return pair->value;
+            }
+            slot = (slot + 1) & object->index_mask;
+        }
+        return NULL;
+    }
+
+    for (size_t i = 0; i < object->size; i++) {
+        const JsonKeyValue* pair = &object->pairs[i];
+        if (pair->hash == hash && pair->key_length == key_length &&
+            memcmp(pair->key, key, key_length) == 0) {
+            return pair->value;
+        }
+    }
+    return NULL;
+}
+
 double json_value_get_number(JsonValue* value) {
-    return (value && value->type == JSON_NUMBER) ? value->value.number : 0.0;
+    if (!value) return 0.0;
+    switch (value->type) {
+        case JSON_NUMBER: return value->value.number;
+        case JSON_INT64: return (double)value->value.int64;
+        case JSON_UINT64: return (double)value->value.uint64;
+        default: return 0.0;
+    }
+}
+
+// 获取整数值：超出int64_t范围或不是数字时返回0，JSON_NUMBER向零取整
+int64_t json_value_get_int64(JsonValue* value) {
+    if (!value) return 0;
+    switch (value->type) {
+        case JSON_INT64:
+            return value->value.int64;
+        case JSON_UINT64:
+            return 0;
+        case JSON_NUMBER:
+            if (value->value.number >= -9223372036854775808.0 && value->value.number < 9223372036854775808.0) {
+                return (int64_t)value->value.number;
+            }
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+// 获取无符号整数值：负数、超出uint64_t范围或不是数字时返回0
+uint64_t json_value_get_uint64(JsonValue* value) {
+    if (!value) return 0;
+    switch (value->type) {
+        case JSON_INT64:
+            return value->value.int64 >= 0 ? (uint64_t)value->value.int64 : 0;
+        case JSON_UINT64:
+            return value->value.uint64;
+        case JSON_NUMBER:
+            if (value->value.number >= 0.0 && value->value.number < 18446744073709551616.0) {
+                return (uint64_t)value->value.number;
+            }
+            return 0;
+        default:
+            return 0;
+    }
+}
+
+// 是否为数字（JSON_NUMBER、JSON_INT64或JSON_UINT64）
+bool json_value_is_number(JsonValue* value) {
+    return value && (value->type == JSON_NUMBER || value->type == JSON_INT64 || value->type == JSON_UINT64);
 }
 
 bool json_value_get_bool(JsonValue* value) {
@@ -0,0 +1,195 @@
+#include "json_path.h"
+#include "json_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define NOT_AN_INDEX ((size_t)-1)
+
+typedef struct {
+    const char* key;        // 解码后的键，以'\0'结尾
+    size_t key_length;
+    uint32_t hash;
+    size_t index;           // 段是数组下标时的值，否则为NOT_AN_INDEX
+    bool wildcard;
+} JsonPathSegment;
+
+struct JsonPath {
+    size_t count;
+    JsonPathSegment* segments;  // 与解码后的键在同一块内存中，紧跟在结构体之后
+};
+
+// RFC 6901数组下标："0"或不以0开头的十进制数
+static size_t parse_index(const char* key, size_t len) {
+    if (len == 0 || (len > 1 && key[0] == '0')) return NOT_AN_INDEX;
+    size_t index = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (key[i] < '0' || key[i] > '9') return NOT_AN_INDEX;
+        if (index > (NOT_AN_INDEX - 1 - (size_t)(key[i] - '0')) / 10) return NOT_AN_INDEX;
+        index = index * 10 + (size_t)(key[i] - '0');
+    }
+    return index;
+}
+
+JsonPath* json_path_compile(const char* pointer, unsigned flags) {
+    if (!pointer) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    return json_path_compile_n(pointer, strlen(pointer), flags);
+}
+
+JsonPath* json_path_compile_n(const char* pointer, size_t len, unsigned flags) {
+    if (!pointer || (flags & ~(unsigned)JSON_PATH_WILDCARD)) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    if (len > 0 && pointer[0] != '/') {
+        json_set_error(JSON_ERROR_POINTER_START);
+        return NULL;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (pointer[i] == '/') count++;
+    }
+
+    // 解码后的键不会比原文长，每段再加一个'\0'
+    JsonPath* path = (JsonPath*)json_malloc(NULL, sizeof(JsonPath) + count * sizeof(JsonPathSegment) + len + count);
+    if (!path) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    path->count = count;
+    path->segments = (JsonPathSegment*)(path + 1);
+    char* keys = (char*)(path->segments + count);
+
+    size_t pos = 1;
+    for (size_t i = 0; i < count; i++) {
+        JsonPathSegment* segment = &path->segments[i];
+        char* key = keys;
+        size_t key_length = 0;
+        for (; pos < len && pointer[pos] != '/'; pos++) {
+            char c = pointer[pos];
+            if (c == '~') {
+                char next = pos + 1 < len ? pointer[pos + 1] : '\0';
+                if (next != '0' && next != '1') {
+                    json_set_error_at(JSON_ERROR_POINTER_ESCAPE, pos);
+                    json_free(NULL, path);
+                    return NULL;
+                }
+                c = next == '0' ? '~' : '/';
+                pos++;
+            }
+            key[key_length++] = c;
+        }
+        key[key_length] = '\0';
+        pos++;
+        keys += key_length + 1;
+
+        segment->key = key;
+        segment->key_length = key_length;
+        segment->hash = json_hash_key(key, key_length);
+        segment->index = parse_index(key, key_length);
+        segment->wildcard = (flags & JSON_PATH_WILDCARD) && key_length == 1 && key[0] == '*';
+    }
+    return path;
+}
+
+void json_path_free(JsonPath* path) {
+    json_free(NULL, path);
+}
+
+size_t json_path_segment_count(const JsonPath* path) {
+    return path ? path->count : 0;
+}
+
+// ---------- 在JsonValue树上求值 ----------
+
+typedef struct {
+    JsonValue** results;
+    size_t max;
+    size_t count;
+    bool first_only;
+} QueryState;
+
+// 从第depth段开始匹配value，返回false表示已找到第一个匹配，停止搜索
+static bool query_value(const JsonPath* path, size_t depth, JsonValue* value, QueryState* state) {
+    if (depth == path->count) {
+        if (state->count < state->max) state->results[state->count] = value;
+        state->count++;
+        return !state->first_only;
+    }
+
+    const JsonPathSegment* segment = &path->segments[depth];
+    if (value->type == JSON_OBJECT) {
+        JsonObject* object = value->value.object;
+        if (segment->wildcard) {
+            for (size_t i = 0; i < object->size; i++) {
+                if (!query_value(path, depth + 1, object->pairs[i].value, state)) return false;
+            }
+            return true;
+        }
+        JsonValue* member = json_object_get_hashed(object, segment->key, segment->key_length, segment->hash);
+        return member ? query_value(path, depth + 1, member, state) : true;
+    }
+    if (value->type == JSON_ARRAY) {
+        JsonArray* array = value->value.array;
+        if (segment->wildcard) {
+            for (size_t i = 0; i < array->size; i++) {
+                if (!query_value(path, depth + 1, array->elements[i], state)) return false;
+            }
+            return true;
+        }
+        return segment->index < array->size ? query_value(path, depth + 1, array->elements[segment->index], state) : true;
+    }
+    return true;
+}
+
+JsonValue* json_path_get(const JsonPath* path, JsonValue* root) {
+    if (!path || !root) return NULL;
+    JsonValue* result = NULL;
+    QueryState state = {&result, 1, 0, true};
+    query_value(path, 0, root, &state);
+    return result;
+}
+
+size_t json_path_query(const JsonPath* path, JsonValue* root, JsonValue** results, size_t max) {
+    if (!path || !root) return 0;
+    QueryState state = {results, results ? max : 0, 0, false};
+    query_value(path, 0, root, &state);
+    return state.count;
+}
+
+// ---------- 在原始输入上求值 ----------
+
+static JsonCursor find_cursor(const JsonPath* path, size_t depth, JsonCursor cursor) {
+    if (depth == path->count || !cursor.parser) return cursor;
+
+    const JsonPathSegment* segment = &path->segments[depth];
+    if (segment->wildcard) {
+        JsonCursorIter iter = json_cursor_iter(cursor);
+        JsonCursor member;
+        while (json_cursor_next(&iter, NULL, NULL, &member)) {
+            JsonCursor found = find_cursor(path, depth + 1, member);
+            if (found.parser) return found;
+        }
+        JsonCursor missing = {NULL, 0};
+        return missing;
+    }
+
+    JsonCursor next = {NULL, 0};
+    if (json_cursor_type(cursor) == JSON_ARRAY) {
+        if (segment->index != NOT_AN_INDEX) next = json_cursor_at(cursor, segment->index);
+    } else {
+        next = json_cursor_get(cursor, segment->key, segment->key_length);
+    }
+    return find_cursor(path, depth + 1, next);
+}
+
+JsonCursor json_path_get_cursor(const JsonPath* path, JsonCursor root) {
+    if (!path) {
+        JsonCursor missing = {NULL, 0};
+        return missing;
+    }
+    return find_cursor(path, 0, root);
+}
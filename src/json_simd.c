@@ -0,0 +1,425 @@
+#include "json_simd.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JSON_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// 每次处理的字节块大小
+#define JSON_BLOCK_SIZE 64
+
+// 获取当前使用的实现名称
+const char* json_simd_implementation(void) {
+#ifdef JSON_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+    if (__builtin_cpu_supports("sse2")) return "sse2";
+#endif
+    return "scalar";
+}
+
+// 前缀异或：第i位为第0..i位的异或结果，用于由引号位置得到字符串区间
+static uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// 计算被反斜杠转义的字符位置，escaped_carry记录上一块末尾是否有未配对的反斜杠
+static uint64_t find_escaped(uint64_t backslash, uint64_t* escaped_carry) {
+    uint64_t escaped = 0;
+    if (*escaped_carry) {
+        escaped = 1;
+        backslash &= ~1ULL;
+        *escaped_carry = 0;
+    }
+    // 反斜杠在正常输入中很少出现，逐个处理即可
+    while (backslash) {
+        int i = __builtin_ctzll(backslash);
+        if (i == JSON_BLOCK_SIZE - 1) {
+            *escaped_carry = 1;
+            break;
+        }
+        escaped |= 1ULL << (i + 1);
+        backslash &= ~(3ULL << i);
+    }
+    return escaped;
+}
+
+// ---------- 跳过整个容器 ----------
+
+// 单个字节块中的括号和引号
+typedef struct {
+    uint64_t open;       // { [
+    uint64_t close;      // } ]
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t comma;
+} BracketMasks;
+
+typedef void (*BracketFn)(const unsigned char* block, BracketMasks* masks);
+
+static void brackets_scalar(const unsigned char* block, BracketMasks* masks) {
+    uint64_t open = 0, close = 0, quote = 0, backslash = 0, comma = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE; i++) {
+        uint64_t bit = 1ULL << i;
+        switch (block[i]) {
+            case '{': case '[': open |= bit; break;
+            case '}': case ']': close |= bit; break;
+            case '"': quote |= bit; break;
+            case '\\': backslash |= bit; break;
+            case ',': comma |= bit; break;
+            default: break;
+        }
+    }
+    masks->open = open;
+    masks->close = close;
+    masks->quote = quote;
+    masks->backslash = backslash;
+    masks->comma = comma;
+}
+
+#ifdef JSON_SIMD_X86
+static void brackets_sse2(const unsigned char* block, BracketMasks* masks) {
+    const __m128i lower = _mm_set1_epi8(0x20);
+    const __m128i open_brace = _mm_set1_epi8('{');
+    const __m128i close_brace = _mm_set1_epi8('}');
+    const __m128i dq = _mm_set1_epi8('"');
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i cm = _mm_set1_epi8(',');
+
+    uint64_t open = 0, close = 0, quote = 0, backslash = 0, comma = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(block + i));
+        __m128i folded = _mm_or_si128(v, lower);
+        open |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(folded, open_brace)) << i;
+        close |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(folded, close_brace)) << i;
+        quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, dq)) << i;
+        backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, bs)) << i;
+        comma |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, cm)) << i;
+    }
+    masks->open = open;
+    masks->close = close;
+    masks->quote = quote;
+    masks->backslash = backslash;
+    masks->comma = comma;
+}
+
+__attribute__((target("avx2")))
+static void brackets_avx2(const unsigned char* block, BracketMasks* masks) {
+    const __m256i lower = _mm256_set1_epi8(0x20);
+    const __m256i open_brace = _mm256_set1_epi8('{');
+    const __m256i close_brace = _mm256_set1_epi8('}');
+    const __m256i dq = _mm256_set1_epi8('"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i cm = _mm256_set1_epi8(',');
+
+    uint64_t open = 0, close = 0, quote = 0, backslash = 0, comma = 0;
+    for (int i = 0; i < JSON_BLOCK_SIZE; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(block + i));
+        __m256i folded = _mm256_or_si256(v, lower);
+        open |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, open_brace)) << i;
+        close |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(folded, close_brace)) << i;
+        quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, dq)) << i;
+        backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, bs)) << i;
+        comma |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, cm)) << i;
+    }
+    masks->open = open;
+    masks->close = close;
+    masks->quote = quote;
+    masks->backslash = backslash;
+    masks->comma = comma;
+}
+#endif
+
+static BracketFn select_brackets(void) {
+#ifdef JSON_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return brackets_avx2;
+    if (__builtin_cpu_supports("sse2")) return brackets_sse2;
+#endif
+    return brackets_scalar;
+}
+
+// 由引号和反斜杠的位掩码得到字符串区间，排除字符串内的括号；一块内的结束括号少于当前深度时
+// 容器不可能在这一块结束，只按位计数更新深度，否则逐个括号查找结束位置
+size_t json_simd_skip_container(const char* json, size_t pos, size_t len) {
+    BracketFn classify = select_brackets();
+    uint64_t escaped_carry = 0;
+    uint64_t in_string_carry = 0;
+    size_t depth = 0;
+
+    for (size_t base = pos; base < len; base += JSON_BLOCK_SIZE) {
+        BracketMasks masks;
+        uint64_t valid = ~0ULL;
+        size_t remaining = len - base;
+
+        if (remaining >= JSON_BLOCK_SIZE) {
+            classify((const unsigned char*)json + base, &masks);
+        } else {
+            unsigned char tail[JSON_BLOCK_SIZE];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, json + base, remaining);
+            classify(tail, &masks);
+            valid = (1ULL << remaining) - 1;
+        }
+
+        uint64_t escaped = find_escaped(masks.backslash, &escaped_carry);
+        uint64_t in_string = prefix_xor(masks.quote & ~escaped) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+
+        uint64_t open = masks.open & ~in_string & valid;
+        uint64_t close = masks.close & ~in_string & valid;
+        size_t closes = (size_t)__builtin_popcountll(close);
+        if (closes < depth) {
+            depth = depth + (size_t)__builtin_popcountll(open) - closes;
+            continue;
+        }
+
+        uint64_t brackets = open | close;
+        while (brackets) {
+            int i = __builtin_ctzll(brackets);
+            if (open & (1ULL << i)) {
+                depth++;
+            } else if (--depth == 0) {
+                return base + (size_t)i + 1;
+            }
+            brackets &= brackets - 1;
+        }
+    }
+    return 0;
+}
+
+// 与json_simd_skip_container相同的方法匹配数组的结束括号，同时在第一层的逗号处切分：
+// 不需要切分的块仍按位计数更新深度，只有跨过下一个切分目标的块才逐个检查逗号
+size_t json_simd_split_array(const char* json, size_t pos, size_t len, size_t gap,
+                             size_t* splits, size_t max_splits, size_t* split_count) {
+    BracketFn classify = select_brackets();
+    uint64_t escaped_carry = 0;
+    uint64_t in_string_carry = 0;
+    size_t depth = 0;
+    size_t target = pos + gap;
+    *split_count = 0;
+
+    for (size_t base = pos; base < len; base += JSON_BLOCK_SIZE) {
+        BracketMasks masks;
+        uint64_t valid = ~0ULL;
+        size_t remaining = len - base;
+
+        if (remaining >= JSON_BLOCK_SIZE) {
+            classify((const unsigned char*)json + base, &masks);
+        } else {
+            unsigned char tail[JSON_BLOCK_SIZE];
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, json + base, remaining);
+            classify(tail, &masks);
+            valid = (1ULL << remaining) - 1;
+        }
+
+        uint64_t escaped = find_escaped(masks.backslash, &escaped_carry);
+        uint64_t in_string = prefix_xor(masks.quote & ~escaped) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+
+        uint64_t open = masks.open & ~in_string & valid;
+        uint64_t close = masks.close & ~in_string & valid;
+        size_t closes = (size_t)__builtin_popcountll(close);
+        bool splitting = base + JSON_BLOCK_SIZE > target && *split_count < max_splits;
+        if (closes < depth && !splitting) {
+            depth = depth + (size_t)__builtin_popcountll(open) - closes;
+            continue;
+        }
+
+        uint64_t events = open | close;
+        if (splitting) events |= masks.comma & ~in_string & valid;
+        while (events) {
+            int i = __builtin_ctzll(events);
+            uint64_t bit = 1ULL << i;
+            if (open & bit) {
+                depth++;
+            } else if (close & bit) {
+                if (--depth == 0) return base + (size_t)i + 1;
+            } else if (depth == 1 && base + (size_t)i >= target && *split_count < max_splits) {
+                splits[(*split_count)++] = base + (size_t)i;
+                target = base + (size_t)i + gap;
+            }
+            events &= events - 1;
+        }
+    }
+    return 0;
+}
+
+// 判断是否为JSON空白字符
+static int is_whitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// 标量实现：跳过空白
+static size_t skip_whitespace_scalar(const char* json, size_t pos, size_t len) {
+    while (pos < len && is_whitespace(json[pos])) pos++;
+    return pos;
+}
+
+// 标量实现：查找引号或反斜杠
+static size_t find_quote_or_backslash_scalar(const char* json, size_t pos, size_t len) {
+    while (pos < len && json[pos] != '"' && json[pos] != '\\') pos++;
+    return pos;
+}
+
+// 标量实现：查找需要转义的字节
+static size_t find_escape_scalar(const char* json, size_t pos, size_t len, bool ascii_only) {
+    while (pos < len) {
+        unsigned char c = (unsigned char)json[pos];
+        if (c < 0x20 || c == '"' || c == '\\' || (ascii_only && c >= 0x80)) break;
+        pos++;
+    }
+    return pos;
+}
+
+#ifdef JSON_SIMD_X86
+// SSE2实现：每次检查16字节
+static size_t skip_whitespace_sse2(const char* json, size_t pos, size_t len) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(json + pos));
+        __m128i is_ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(is_ws) & 0xFFFFu;
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+    return skip_whitespace_scalar(json, pos, len);
+}
+
+static size_t find_quote_or_backslash_sse2(const char* json, size_t pos, size_t len) {
+    const __m128i dq = _mm_set1_epi8('"');
+    const __m128i bs = _mm_set1_epi8('\\');
+
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(json + pos));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, dq), _mm_cmpeq_epi8(v, bs)));
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+    return find_quote_or_backslash_scalar(json, pos, len);
+}
+
+// 控制字符用无符号比较：max(v, 0x1F) == 0x1F 当且仅当 v <= 0x1F；非ASCII字节即最高位为1
+static size_t find_escape_sse2(const char* json, size_t pos, size_t len, bool ascii_only) {
+    const __m128i dq = _mm_set1_epi8('"');
+    const __m128i bs = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+
+    while (pos + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(json + pos));
+        __m128i hit = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, dq), _mm_cmpeq_epi8(v, bs)),
+            _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl), ctrl));
+        unsigned mask = (unsigned)_mm_movemask_epi8(hit);
+        if (ascii_only) mask |= (unsigned)_mm_movemask_epi8(v);
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+    return find_escape_scalar(json, pos, len, ascii_only);
+}
+
+// AVX2实现：每次检查32字节。不足32字节的尾部交给SSE2实现前先清除ymm高位，
+// 否则尾调用不会插入vzeroupper，之后的SSE指令要承受AVX/SSE状态切换的开销
+__attribute__((target("avx2")))
+static size_t skip_whitespace_avx2(const char* json, size_t pos, size_t len) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+
+    while (pos + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(json + pos));
+        __m256i is_ws = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(is_ws);
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 32;
+    }
+    _mm256_zeroupper();
+    return skip_whitespace_sse2(json, pos, len);
+}
+
+__attribute__((target("avx2")))
+static size_t find_quote_or_backslash_avx2(const char* json, size_t pos, size_t len) {
+    const __m256i dq = _mm256_set1_epi8('"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+
+    while (pos + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(json + pos));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, dq), _mm256_cmpeq_epi8(v, bs)));
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 32;
+    }
+    _mm256_zeroupper();
+    return find_quote_or_backslash_sse2(json, pos, len);
+}
+
+__attribute__((target("avx2")))
+static size_t find_escape_avx2(const char* json, size_t pos, size_t len, bool ascii_only) {
+    const __m256i dq = _mm256_set1_epi8('"');
+    const __m256i bs = _mm256_set1_epi8('\\');
+    const __m256i ctrl = _mm256_set1_epi8(0x1F);
+
+    while (pos + 32 <= len) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(json + pos));
+        __m256i hit = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, dq), _mm256_cmpeq_epi8(v, bs)),
+            _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl), ctrl));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(hit);
+        if (ascii_only) mask |= (uint32_t)_mm256_movemask_epi8(v);
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 32;
+    }
+    _mm256_zeroupper();
+    return find_escape_sse2(json, pos, len, ascii_only);
+}
+#endif
+
+// 跳过空白：空白通常很短，先逐字节检查，遇到较长的空白再切换到向量实现
+size_t json_simd_skip_whitespace(const char* json, size_t pos, size_t len) {
+    for (int i = 0; i < 4; i++) {
+        if (pos >= len || !is_whitespace(json[pos])) return pos;
+        pos++;
+    }
+#ifdef JSON_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return skip_whitespace_avx2(json, pos, len);
+    return skip_whitespace_sse2(json, pos, len);
+#else
+    return skip_whitespace_scalar(json, pos, len);
+#endif
+}
+
+// 查找引号或反斜杠
+size_t json_simd_find_quote_or_backslash(const char* json, size_t pos, size_t len) {
+#ifdef JSON_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return find_quote_or_backslash_avx2(json, pos, len);
+    return find_quote_or_backslash_sse2(json, pos, len);
+#else
+    return find_quote_or_backslash_scalar(json, pos, len);
+#endif
+}
+
+// 查找需要转义的字节
+size_t json_simd_find_escape(const char* json, size_t pos, size_t len, bool ascii_only) {
+#ifdef JSON_SIMD_X86
+    if (__builtin_cpu_supports("avx2")) return find_escape_avx2(json, pos, len, ascii_only);
+    return find_escape_sse2(json, pos, len, ascii_only);
+#else
+    return find_escape_scalar(json, pos, len, ascii_only);
+#endif
+}
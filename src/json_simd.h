@@ -0,0 +1,32 @@
+#ifndef JSON_SIMD_H
+#define JSON_SIMD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 库内部使用的向量化扫描函数，运行时根据CPU选择AVX2/SSE2/标量实现
+
+// 从pos开始查找第一个非空白字符，不存在时返回len
+size_t json_simd_skip_whitespace(const char* json, size_t pos, size_t len);
+
+// 从pos开始查找第一个'"'或'\\'，不存在时返回len
+size_t json_simd_find_quote_or_backslash(const char* json, size_t pos, size_t len);
+
+// 从pos开始查找第一个需要转义的字节：'"'、'\\'、控制字符（0x00-0x1F），
+// ascii_only时还包括非ASCII字节；不存在时返回len
+size_t json_simd_find_escape(const char* json, size_t pos, size_t len, bool ascii_only);
+
+// 跳过从pos处的'{'或'['开始的整个容器，返回匹配的结束括号之后的位置，不存在时返回0；
+// 字符串内（包括转义的引号之后）的括号不计入，不校验容器内的语法
+size_t json_simd_skip_container(const char* json, size_t pos, size_t len);
+
+// 匹配从pos处的'['开始的数组，返回结束括号之后的位置，不存在时返回0；
+// 同时记录第一层的逗号位置作为切分点，相邻切分点至少相隔gap字节，最多max_splits个
+size_t json_simd_split_array(const char* json, size_t pos, size_t len, size_t gap,
+                             size_t* splits, size_t max_splits, size_t* split_count);
+
+// 当前使用的实现名称（"avx2"、"sse2"或"scalar"）
+const char* json_simd_implementation(void);
+
+#endif // JSON_SIMD_H
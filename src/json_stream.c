@@ -0,0 +1,755 @@
+#include "json_parser.h"
+#include "json_internal.h"
+#include "json_number.h"
+#include "json_simd.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 增量解析所处的状态
+typedef enum {
+    PUSH_VALUE,          // 期待一个值
+    PUSH_ARRAY_FIRST,    // '['之后：期待值或']'
+    PUSH_OBJECT_FIRST,   // '{'之后：期待键或'}'
+    PUSH_KEY,            // 对象中','之后：期待键
+    PUSH_COLON,          // 键之后：期待':'
+    PUSH_AFTER_VALUE,    // 容器中的值之后：期待','或结束符
+    PUSH_STRING,         // 字符串内部
+    PUSH_ESCAPE,         // 字符串内反斜杠之后
+    PUSH_NUMBER,         // 数字内部
+    PUSH_LITERAL,        // true/false/null内部
+    PUSH_DONE,           // 已得到完整的值
+    PUSH_ERROR
+} PushState;
+
+// 由事件构建值树
+typedef struct {
+    JsonValue** nodes;     // 当前打开的容器
+    size_t depth;
+    size_t capacity;
+    char* pending_key;
+    size_t pending_key_len;
+    JsonValue* root;
+    const JsonAllocator* allocator;    // 节点、字符串和容器数组的分配器，NULL时使用全局分配器
+} TreeBuilder;
+
+// 增量解析状态
+struct JsonPushState {
+    PushState state;
+    const JsonHandler* handler;
+    void* ctx;
+    bool user_handler;     // 调用方提供的回调中止时不会设置错误消息
+    JsonExactNumberFn exact_number;    // 非空时代替handler->number，数字不经过double
+
+    // 未完成的记号：字符串的原始内容（转义在结束时统一解码）或数字文本
+    char* scratch;
+    size_t scratch_len;
+    size_t scratch_cap;
+    bool string_is_key;
+    bool string_fresh;     // 字符串刚开始，尚未跨块，可直接引用输入
+    bool string_escaped;   // 字符串中出现过转义
+    const char* literal;
+    size_t literal_len;
+    size_t literal_pos;
+
+    // 容器栈：'['或'{'
+    char* stack;
+    size_t depth;
+    size_t stack_cap;
+
+    // 出错位置：之前各块的总字节数加上当前块中正在处理的位置
+    size_t consumed;
+    size_t chunk_pos;
+
+    const JsonAllocator* allocator;    // 状态本身、scratch和容器栈的分配器
+    TreeBuilder tree;
+};
+
+// ---------- 构建值树 ----------
+
+// 创建节点并挂到当前容器下
+static JsonValue* tree_attach(TreeBuilder* tree, JsonValueType type) {
+    JsonValue* value = (JsonValue*)json_malloc(tree->allocator, sizeof(JsonValue));
+    if (!value) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    memset(value, 0, sizeof(JsonValue));
+    value->type = type;
+
+    if (tree->depth == 0) {
+        tree->root = value;
+        return value;
+    }
+
+    JsonValue* parent = tree->nodes[tree->depth - 1];
+    if (parent->type == JSON_ARRAY) {
+        JsonArray* array = parent->value.array;
+        if (array->size >= array->capacity) {
+            size_t new_capacity = array->capacity * 2;
+            JsonValue** new_elements = (JsonValue**)json_realloc(tree->allocator, array->elements,
+                                                            sizeof(JsonValue*) * new_capacity);
+            if (!new_elements) {
+                json_free(tree->allocator, value);
+                json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+                return NULL;
+            }
+            array->elements = new_elements;
+            array->capacity = new_capacity;
+        }
+        array->elements[array->size++] = value;
+    } else {
+        JsonObject* object = parent->value.object;
+        if (object->size >= object->capacity) {
+            size_t new_capacity = object->capacity * 2;
+            JsonKeyValue* new_pairs = (JsonKeyValue*)json_realloc(tree->allocator, object->pairs,
+                                                             sizeof(JsonKeyValue) * new_capacity);
+            if (!new_pairs) {
+                json_free(tree->allocator, value);
+                json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+                return NULL;
+            }
+            object->pairs = new_pairs;
+            object->capacity = new_capacity;
+        }
+        object->pairs[object->size].key = tree->pending_key;
+        object->pairs[object->size].key_length = tree->pending_key_len;
+        object->pairs[object->size].hash = json_hash_key(tree->pending_key, tree->pending_key_len);
+        object->pairs[object->size].value = value;
+        object->size++;
+        tree->pending_key = NULL;
+    }
+    return value;
+}
+
+// 复制字符串并追加结束符
+static char* copy_string(const TreeBuilder* tree, const char* str, size_t len) {
+    char* copy = (char*)json_malloc(tree->allocator, len + 1);
+    if (!copy) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+static bool tree_start_container(TreeBuilder* tree, JsonValueType type) {
+    if (tree->depth >= tree->capacity) {
+        size_t new_capacity = tree->capacity ? tree->capacity * 2 : 16;
+        JsonValue** new_nodes = (JsonValue**)json_realloc(tree->allocator, tree->nodes, sizeof(JsonValue*) * new_capacity);
+        if (!new_nodes) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        tree->nodes = new_nodes;
+        tree->capacity = new_capacity;
+    }
+
+    JsonValue* value = tree_attach(tree, type);
+    if (!value) return false;
+
+    if (type == JSON_ARRAY) {
+        JsonArray* array = (JsonArray*)json_malloc(tree->allocator, sizeof(JsonArray));
+        if (!array) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        array->size = 0;
+        array->capacity = 8;
+        array->elements = (JsonValue**)json_malloc(tree->allocator, sizeof(JsonValue*) * array->capacity);
+        if (!array->elements) {
+            json_free(tree->allocator, array);
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        value->value.array = array;
+    } else {
+        JsonObject* object = (JsonObject*)json_malloc(tree->allocator, sizeof(JsonObject));
+        if (!object) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        object->size = 0;
+        object->capacity = 8;
+        object->index = NULL;
+        object->index_mask = 0;
+        object->pairs = (JsonKeyValue*)json_malloc(tree->allocator, sizeof(JsonKeyValue) * object->capacity);
+        if (!object->pairs) {
+            json_free(tree->allocator, object);
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        value->value.object = object;
+    }
+
+    tree->nodes[tree->depth++] = value;
+    return true;
+}
+
+static bool tree_start_object(void* ctx) {
+    return tree_start_container((TreeBuilder*)ctx, JSON_OBJECT);
+}
+
+static bool tree_start_array(void* ctx) {
+    return tree_start_container((TreeBuilder*)ctx, JSON_ARRAY);
+}
+
+static bool tree_end_array(void* ctx) {
+    ((TreeBuilder*)ctx)->depth--;
+    return true;
+}
+
+// 对象结束时为成员较多的对象建立哈希索引
+static bool tree_end_object(void* ctx) {
+    TreeBuilder* tree = (TreeBuilder*)ctx;
+    JsonObject* object = tree->nodes[--tree->depth]->value.object;
+    size_t slot_count = json_object_index_slots(object->size);
+    if (slot_count == 0) return true;
+
+    uint32_t* slots = (uint32_t*)json_calloc(tree->allocator, slot_count, sizeof(uint32_t));
+    if (!slots) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    json_object_fill_index(object, slots, slot_count);
+    return true;
+}
+
+static bool tree_key(void* ctx, const char* key, size_t len) {
+    TreeBuilder* tree = (TreeBuilder*)ctx;
+    tree->pending_key = copy_string(tree, key, len);
+    tree->pending_key_len = len;
+    return tree->pending_key != NULL;
+}
+
+static bool tree_string(void* ctx, const char* str, size_t len) {
+    TreeBuilder* tree = (TreeBuilder*)ctx;
+    char* copy = copy_string(tree, str, len);
+    if (!copy) return false;
+
+    JsonValue* value = tree_attach(tree, JSON_STRING);
+    if (!value) {
+        json_free(tree->allocator, copy);
+        return false;
+    }
+    value->value.string = copy;
+    value->length = len;
+    return true;
+}
+
+static bool tree_number(void* ctx, double number) {
+    JsonValue* value = tree_attach((TreeBuilder*)ctx, JSON_NUMBER);
+    if (!value) return false;
+    value->value.number = number;
+    return true;
+}
+
+static bool tree_boolean(void* ctx, bool boolean) {
+    JsonValue* value = tree_attach((TreeBuilder*)ctx, JSON_BOOL);
+    if (!value) return false;
+    value->value.boolean = boolean;
+    return true;
+}
+
+static bool tree_null(void* ctx) {
+    return tree_attach((TreeBuilder*)ctx, JSON_NULL) != NULL;
+}
+
+// 释放构建器及尚未取走的值
+static void tree_free(TreeBuilder* tree) {
+    json_free(tree->allocator, tree->nodes);
+    json_free(tree->allocator, tree->pending_key);
+    json_value_free_with(tree->root, tree->allocator);
+}
+
+static const JsonHandler tree_handler = {
+    tree_start_object,
+    tree_end_object,
+    tree_start_array,
+    tree_end_array,
+    tree_key,
+    tree_string,
+    tree_number,
+    tree_boolean,
+    tree_null
+};
+
+// ---------- 忽略事件的默认回调 ----------
+
+static bool ignore_event(void* ctx) {
+    (void)ctx;
+    return true;
+}
+
+static bool ignore_string(void* ctx, const char* str, size_t len) {
+    (void)ctx;
+    (void)str;
+    (void)len;
+    return true;
+}
+
+static bool ignore_number(void* ctx, double number) {
+    (void)ctx;
+    (void)number;
+    return true;
+}
+
+static bool ignore_boolean(void* ctx, bool boolean) {
+    (void)ctx;
+    (void)boolean;
+    return true;
+}
+
+// 用忽略事件的回调补全调用方未提供的回调，词法分析中无需逐个判空
+static void handler_fill(JsonHandler* dst, const JsonHandler* src) {
+    *dst = *src;
+    if (!dst->start_object) dst->start_object = ignore_event;
+    if (!dst->end_object) dst->end_object = ignore_event;
+    if (!dst->start_array) dst->start_array = ignore_event;
+    if (!dst->end_array) dst->end_array = ignore_event;
+    if (!dst->key) dst->key = ignore_string;
+    if (!dst->string) dst->string = ignore_string;
+    if (!dst->number) dst->number = ignore_number;
+    if (!dst->boolean) dst->boolean = ignore_boolean;
+    if (!dst->null) dst->null = ignore_event;
+}
+
+// ---------- 增量词法分析 ----------
+
+// 创建增量解析状态，状态、缓冲区和构建的值树都经由allocator
+static struct JsonPushState* push_state_create(const JsonHandler* handler, void* ctx,
+                                               const JsonAllocator* allocator) {
+    struct JsonPushState* push = (struct JsonPushState*)json_malloc(allocator, sizeof(struct JsonPushState));
+    if (!push) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+    memset(push, 0, sizeof(struct JsonPushState));
+    push->state = PUSH_VALUE;
+    push->handler = handler;
+    push->ctx = ctx;
+    push->allocator = allocator;
+    push->tree.allocator = allocator;
+    return push;
+}
+
+// 释放增量解析状态及尚未取走的值
+void json_push_state_free(struct JsonPushState* push) {
+    if (!push) return;
+    json_free(push->allocator, push->scratch);
+    json_free(push->allocator, push->stack);
+    tree_free(&push->tree);
+    json_free(push->allocator, push);
+}
+
+// 进入错误状态，记录出错位置；code为JSON_ERROR_NONE时沿用已设置的错误码
+static JsonFeedStatus push_fail(struct JsonPushState* push, JsonErrorCode code) {
+    if (code == JSON_ERROR_NONE) code = json_get_last_error().code;
+    json_set_error_at(code, push->consumed + push->chunk_pos);
+    push->state = PUSH_ERROR;
+    return JSON_FEED_ERROR;
+}
+
+// 检查回调结果，调用方的回调中止解析时补充错误消息
+static bool handler_ok(struct JsonPushState* push, bool ok) {
+    if (!ok && push->user_handler) json_set_error(JSON_ERROR_ABORTED);
+    return ok;
+}
+
+// 追加到未完成记号的缓冲区
+static bool scratch_append(struct JsonPushState* push, const char* data, size_t len) {
+    if (push->scratch_len + len + 1 > push->scratch_cap) {
+        size_t new_capacity = push->scratch_cap ? push->scratch_cap * 2 : 64;
+        while (new_capacity < push->scratch_len + len + 1) new_capacity *= 2;
+        char* new_scratch = (char*)json_realloc(push->allocator, push->scratch, new_capacity);
+        if (!new_scratch) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        push->scratch = new_scratch;
+        push->scratch_cap = new_capacity;
+    }
+    memcpy(push->scratch + push->scratch_len, data, len);
+    push->scratch_len += len;
+    return true;
+}
+
+// 一个值结束后的状态
+static void value_done(struct JsonPushState* push) {
+    push->state = push->depth == 0 ? PUSH_DONE : PUSH_AFTER_VALUE;
+}
+
+// 压入容器
+static bool push_container(struct JsonPushState* push, char type) {
+    if (push->depth >= push->stack_cap) {
+        size_t new_capacity = push->stack_cap ? push->stack_cap * 2 : 16;
+        char* new_stack = (char*)json_realloc(push->allocator, push->stack, new_capacity);
+        if (!new_stack) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        push->stack = new_stack;
+        push->stack_cap = new_capacity;
+    }
+    bool ok = type == '{' ? push->handler->start_object(push->ctx)
+                          : push->handler->start_array(push->ctx);
+    if (!handler_ok(push, ok)) return false;
+    push->stack[push->depth++] = type;
+    push->state = type == '{' ? PUSH_OBJECT_FIRST : PUSH_ARRAY_FIRST;
+    return true;
+}
+
+// 弹出容器
+static bool pop_container(struct JsonPushState* push) {
+    char type = push->stack[--push->depth];
+    bool ok = type == '{' ? push->handler->end_object(push->ctx)
+                          : push->handler->end_array(push->ctx);
+    if (!handler_ok(push, ok)) return false;
+    value_done(push);
+    return true;
+}
+
+// 完成字符串或键
+static bool finish_string(struct JsonPushState* push, const char* str, size_t len) {
+    if (push->string_is_key) {
+        if (!handler_ok(push, push->handler->key(push->ctx, str, len))) return false;
+        push->state = PUSH_COLON;
+        return true;
+    }
+    if (!handler_ok(push, push->handler->string(push->ctx, str, len))) return false;
+    value_done(push);
+    return true;
+}
+
+// 完成暂存在scratch中的字符串，含转义时先原地解码
+static bool finish_scratch_string(struct JsonPushState* push) {
+    size_t len = push->scratch_len;
+    if (push->string_escaped) {
+        len = json_unescape_string(push->scratch, push->scratch, push->scratch_len, NULL);
+        if (len == JSON_UNESCAPE_INVALID) {
+            json_set_error(JSON_ERROR_INVALID_ESCAPE);
+            return false;
+        }
+    }
+    return finish_string(push, push->scratch, len);
+}
+
+// 完成数字：整个数字文本必须都能被转换
+static bool finish_number(struct JsonPushState* push) {
+    JsonNumber number;
+    if (json_number_parse(push->scratch, push->scratch_len, &number) != push->scratch_len) {
+        json_set_error(JSON_ERROR_INVALID_NUMBER);
+        return false;
+    }
+    bool ok = push->exact_number ? push->exact_number(push->ctx, &number)
+                                 : push->handler->number(push->ctx, json_number_to_double(&number));
+    if (!handler_ok(push, ok)) return false;
+    value_done(push);
+    return true;
+}
+
+// 完成字面量
+static bool finish_literal(struct JsonPushState* push) {
+    bool ok;
+    switch (push->literal[0]) {
+        case 't': ok = push->handler->boolean(push->ctx, true); break;
+        case 'f': ok = push->handler->boolean(push->ctx, false); break;
+        default: ok = push->handler->null(push->ctx); break;
+    }
+    if (!handler_ok(push, ok)) return false;
+    value_done(push);
+    return true;
+}
+
+// 判断是否为数字字符
+static bool is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// 开始解析一个值
+static JsonFeedStatus begin_value(struct JsonPushState* push, char c) {
+    switch (c) {
+        case '{':
+        case '[':
+            if (!push_container(push, c)) return push_fail(push, JSON_ERROR_NONE);
+            return JSON_FEED_NEED_MORE;
+        case '"':
+            push->string_is_key = false;
+            push->string_fresh = true;
+            push->string_escaped = false;
+            push->scratch_len = 0;
+            push->state = PUSH_STRING;
+            return JSON_FEED_NEED_MORE;
+        case 't':
+        case 'f':
+        case 'n':
+            push->literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+            push->literal_len = strlen(push->literal);
+            push->literal_pos = 1;
+            push->state = PUSH_LITERAL;
+            return JSON_FEED_NEED_MORE;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9')) {
+                push->scratch_len = 0;
+                if (!scratch_append(push, &c, 1)) return push_fail(push, JSON_ERROR_NONE);
+                push->state = PUSH_NUMBER;
+                return JSON_FEED_NEED_MORE;
+            }
+            return push_fail(push, JSON_ERROR_INVALID_VALUE);
+    }
+}
+
+// 处理一块输入
+static JsonFeedStatus push_feed(struct JsonPushState* push, const char* data, size_t len) {
+    size_t i = 0;
+    while (i < len && push->state != PUSH_ERROR) {
+        push->chunk_pos = i;
+        switch (push->state) {
+            case PUSH_STRING: {
+                size_t end = json_simd_find_quote_or_backslash(data, i, len);
+                if (end < len && data[end] == '"' && push->string_fresh) {
+                    // 整个字符串都在当前块内且没有转义，直接引用输入
+                    push->string_fresh = false;
+                    if (!finish_string(push, data + i, end - i)) return push_fail(push, JSON_ERROR_NONE);
+                    i = end + 1;
+                    continue;
+                }
+                push->string_fresh = false;
+                if (!scratch_append(push, data + i, end - i)) return push_fail(push, JSON_ERROR_NONE);
+                i = end;
+                if (i >= len) break;
+                i++;
+                if (data[end] == '\\') {
+                    push->state = PUSH_ESCAPE;
+                } else if (!finish_scratch_string(push)) {
+                    return push_fail(push, JSON_ERROR_NONE);
+                }
+                continue;
+            }
+
+            case PUSH_ESCAPE: {
+                // 保留原始转义，\uXXXX的十六进制数字可能跨块，字符串结束时整体解码
+                char escape[2] = {'\\', data[i]};
+                if (!strchr("\"\\/bfnrtu", escape[1]) || escape[1] == '\0') {
+                    return push_fail(push, JSON_ERROR_INVALID_ESCAPE);
+                }
+                i++;
+                if (!scratch_append(push, escape, 2)) return push_fail(push, JSON_ERROR_NONE);
+                push->string_escaped = true;
+                push->state = PUSH_STRING;
+                continue;
+            }
+
+            case PUSH_NUMBER: {
+                size_t end = i;
+                while (end < len && is_number_char(data[end])) end++;
+                if (!scratch_append(push, data + i, end - i)) return push_fail(push, JSON_ERROR_NONE);
+                i = end;
+                if (i < len && !finish_number(push)) return push_fail(push, JSON_ERROR_NONE);
+                continue;
+            }
+
+            case PUSH_LITERAL:
+                if (data[i] != push->literal[push->literal_pos]) {
+                    return push_fail(push, push->literal[0] == 'n' ? JSON_ERROR_INVALID_NULL : JSON_ERROR_INVALID_BOOL);
+                }
+                i++;
+                if (++push->literal_pos == push->literal_len && !finish_literal(push)) {
+                    return push_fail(push, JSON_ERROR_NONE);
+                }
+                continue;
+
+            default:
+                break;
+        }
+
+        // 记号之间：跳过空白后按状态处理结构字符
+        i = json_simd_skip_whitespace(data, i, len);
+        if (i >= len) break;
+        push->chunk_pos = i;
+        char c = data[i++];
+
+        switch (push->state) {
+            case PUSH_ARRAY_FIRST:
+                if (c == ']') {
+                    if (!pop_container(push)) return push_fail(push, JSON_ERROR_NONE);
+                    break;
+                }
+                if (begin_value(push, c) == JSON_FEED_ERROR) return JSON_FEED_ERROR;
+                break;
+
+            case PUSH_VALUE:
+                if (begin_value(push, c) == JSON_FEED_ERROR) return JSON_FEED_ERROR;
+                break;
+
+            case PUSH_OBJECT_FIRST:
+            case PUSH_KEY:
+                if (c == '}' && push->state == PUSH_OBJECT_FIRST) {
+                    if (!pop_container(push)) return push_fail(push, JSON_ERROR_NONE);
+                } else if (c == '"') {
+                    push->string_is_key = true;
+                    push->string_fresh = true;
+                    push->string_escaped = false;
+                    push->scratch_len = 0;
+                    push->state = PUSH_STRING;
+                } else {
+                    return push_fail(push, JSON_ERROR_EXPECTED_STRING);
+                }
+                break;
+
+            case PUSH_COLON:
+                if (c != ':') return push_fail(push, JSON_ERROR_EXPECTED_COLON);
+                push->state = PUSH_VALUE;
+                break;
+
+            case PUSH_AFTER_VALUE:
+                if (push->stack[push->depth - 1] == '[') {
+                    if (c == ',') {
+                        push->state = PUSH_VALUE;
+                    } else if (c == ']') {
+                        if (!pop_container(push)) return push_fail(push, JSON_ERROR_NONE);
+                    } else {
+                        return push_fail(push, JSON_ERROR_EXPECTED_ARRAY_SEPARATOR);
+                    }
+                } else {
+                    if (c == ',') {
+                        push->state = PUSH_KEY;
+                    } else if (c == '}') {
+                        if (!pop_container(push)) return push_fail(push, JSON_ERROR_NONE);
+                    } else {
+                        return push_fail(push, JSON_ERROR_EXPECTED_OBJECT_SEPARATOR);
+                    }
+                }
+                break;
+
+            case PUSH_DONE:
+                return push_fail(push, JSON_ERROR_TRAILING_CHARACTERS);
+
+            default:
+                break;
+        }
+    }
+
+    push->consumed += len;
+    push->chunk_pos = 0;
+    if (push->state == PUSH_ERROR) return JSON_FEED_ERROR;
+    return push->state == PUSH_DONE ? JSON_FEED_COMPLETE : JSON_FEED_NEED_MORE;
+}
+
+// 输入结束：顶层数字此时才算完整，其余未完成的状态均为错误
+static JsonFeedStatus push_finish(struct JsonPushState* push) {
+    switch (push->state) {
+        case PUSH_DONE:
+            return JSON_FEED_COMPLETE;
+        case PUSH_ERROR:
+            return JSON_FEED_ERROR;
+        case PUSH_NUMBER:
+            if (push->depth == 0) {
+                if (!finish_number(push)) return push_fail(push, JSON_ERROR_NONE);
+                return JSON_FEED_COMPLETE;
+            }
+            break;
+        case PUSH_STRING:
+        case PUSH_ESCAPE:
+            return push_fail(push, JSON_ERROR_UNTERMINATED_STRING);
+        default:
+            break;
+    }
+
+    if (push->depth == 0) return push_fail(push, JSON_ERROR_INVALID_VALUE);
+    return push_fail(push, push->stack[push->depth - 1] == '[' ? JSON_ERROR_UNTERMINATED_ARRAY : JSON_ERROR_UNTERMINATED_OBJECT);
+}
+
+// ---------- 公开接口 ----------
+
+// 创建增量解析器
+JsonParser* json_parser_create_push(void) {
+    return json_parser_create_push_with(NULL);
+}
+
+// 使用指定的分配器创建增量解析器：解析器、增量状态、缓冲区和取走的值树都经由allocator
+JsonParser* json_parser_create_push_with(const JsonAllocator* allocator) {
+    JsonParser* parser = json_parser_create_with("", 0, allocator);
+    if (!parser) return NULL;
+
+    parser->push = push_state_create(&tree_handler, NULL, allocator);
+    if (!parser->push) {
+        json_parser_free(parser);
+        return NULL;
+    }
+    parser->push->ctx = &parser->push->tree;
+    return parser;
+}
+
+// 整个输入作为一块送入增量词法分析器
+static bool parse_events(const char* json, size_t len, const JsonHandler* handler,
+                         JsonExactNumberFn exact_number, void* ctx, bool user_handler) {
+    if (!json || !handler) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return false;
+    }
+
+    JsonHandler filled;
+    handler_fill(&filled, handler);
+
+    struct JsonPushState push;
+    memset(&push, 0, sizeof(push));
+    push.state = PUSH_VALUE;
+    push.handler = &filled;
+    push.ctx = ctx;
+    push.user_handler = user_handler;
+    push.exact_number = exact_number;
+
+    JsonFeedStatus status = push_feed(&push, json, len);
+    if (status != JSON_FEED_ERROR) status = push_finish(&push);
+
+    json_free(NULL, push.scratch);
+    json_free(NULL, push.stack);
+    return status == JSON_FEED_COMPLETE;
+}
+
+// 事件驱动解析：不创建任何JsonValue节点
+bool json_parse_events(const char* json, size_t len, const JsonHandler* handler, void* ctx) {
+    return parse_events(json, len, handler, NULL, ctx, true);
+}
+
+// 库内部的事件解析：数字以精确值回调，回调返回false时由回调自行设置错误消息
+bool json_parse_events_exact(const char* json, size_t len, const JsonHandler* handler,
+                             JsonExactNumberFn exact_number, void* ctx) {
+    return parse_events(json, len, handler, exact_number, ctx, false);
+}
+
+// 出错时把错误同时记录到解析器
+static JsonFeedStatus feed_status(JsonParser* parser, JsonFeedStatus status) {
+    if (status == JSON_FEED_ERROR) parser->error = json_get_last_error();
+    return status;
+}
+
+// 送入一块输入，块的边界可以位于任意位置（包括字符串、转义和数字内部）
+JsonFeedStatus json_parser_feed(JsonParser* parser, const char* chunk, size_t len) {
+    if (!parser->push) {
+        json_parser_set_error(parser, JSON_ERROR_NOT_PUSH_PARSER, 0);
+        return JSON_FEED_ERROR;
+    }
+    if (parser->push->state == PUSH_ERROR) return JSON_FEED_ERROR;
+    return feed_status(parser, push_feed(parser->push, chunk, len));
+}
+
+// 标记输入结束
+JsonFeedStatus json_parser_finish(JsonParser* parser) {
+    if (!parser->push) {
+        json_parser_set_error(parser, JSON_ERROR_NOT_PUSH_PARSER, 0);
+        return JSON_FEED_ERROR;
+    }
+    if (parser->push->state == PUSH_ERROR) return JSON_FEED_ERROR;
+    return feed_status(parser, push_finish(parser->push));
+}
+
+// 取走完整的值，之后由调用方负责json_value_free_with(value, 创建时的分配器)
+JsonValue* json_parser_take_value(JsonParser* parser) {
+    if (!parser->push || parser->push->state != PUSH_DONE) return NULL;
+    JsonValue* value = parser->push->tree.root;
+    parser->push->tree.root = NULL;
+    return value;
+}
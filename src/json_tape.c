@@ -0,0 +1,957 @@
+#include "json_tape.h"
+#include "json_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TAPE_TAG_SHIFT 56
+#define TAPE_PAYLOAD_MASK ((UINT64_C(1) << TAPE_TAG_SHIFT) - 1)
+#define TAPE_INDEX_MASK UINT64_C(0xFFFFFFFF)
+#define TAPE_COUNT_MAX 0xFFFFFFu    // 成员数字段饱和时按实际遍历计数
+
+#define SNAPSHOT_MAGIC "LJTAPE01"
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// 构建时打开的容器
+typedef struct {
+    size_t index;       // 开始标记的位置
+    size_t count;       // 已有成员数
+} TapeFrame;
+
+struct JsonTape {
+    uint64_t* words;
+    size_t count;
+    size_t capacity;
+
+    char* strings;      // 每个字符串依次为长度(size_t)、内容和'\0'
+    size_t strings_len;
+    size_t strings_cap;
+
+    unsigned flags;
+    TapeFrame* stack;
+    size_t depth;
+    size_t stack_cap;
+
+    // 由快照加载时各区直接指向快照内容，磁带只读
+    const uint32_t* directory;  // 查找表目录：(容器位置, 表在tables中的偏移)，按容器位置升序
+    size_t directory_count;
+    const uint32_t* tables;
+    size_t tables_len;          // uint32_t个数
+    void* mapping;              // json_tape_load映射的文件
+    size_t mapping_size;
+    bool read_only;
+};
+
+// 快照文件头，之后依次为磁带、字符串区（补齐到8字节）、目录和查找表
+typedef struct {
+    char magic[8];
+    uint32_t byte_order;        // 写入端的字节序标记
+    uint32_t size_bytes;        // sizeof(size_t)，字符串长度按该宽度保存
+    uint64_t word_count;
+    uint64_t strings_len;
+    uint64_t directory_count;   // 目录项数，每项两个uint32_t
+    uint64_t tables_len;        // 查找表的uint32_t个数
+} SnapshotHeader;
+
+static uint64_t make_word(char tag, uint64_t payload) {
+    return ((uint64_t)(unsigned char)tag << TAPE_TAG_SHIFT) | payload;
+}
+
+static char word_tag(uint64_t word) {
+    return (char)(word >> TAPE_TAG_SHIFT);
+}
+
+// ---------- 构建磁带 ----------
+
+// 保证buffer至少能容纳need个elem_size大小的元素，容量按倍数增长
+static bool reserve(void** buffer, size_t* capacity, size_t need, size_t elem_size) {
+    if (need <= *capacity) return true;
+    size_t new_capacity = *capacity ? *capacity * 2 : 64;
+    while (new_capacity < need) new_capacity *= 2;
+    void* new_buffer = json_realloc(NULL, *buffer, new_capacity * elem_size);
+    if (!new_buffer) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        return false;
+    }
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+    return true;
+}
+
+static bool emit(JsonTape* tape, uint64_t word) {
+    if (tape->count == tape->capacity &&
+        !reserve((void**)&tape->words, &tape->capacity, tape->count + 1, sizeof(uint64_t))) {
+        return false;
+    }
+    tape->words[tape->count++] = word;
+    return true;
+}
+
+// 数组中的每个值计为一个成员，对象的成员在遇到键时计数
+static void count_value(JsonTape* tape) {
+    if (tape->depth > 0) {
+        TapeFrame* top = &tape->stack[tape->depth - 1];
+        if (word_tag(tape->words[top->index]) == '[') top->count++;
+    }
+}
+
+static bool tape_start(JsonTape* tape, char tag) {
+    count_value(tape);
+    if (!reserve((void**)&tape->stack, &tape->stack_cap, tape->depth + 1, sizeof(TapeFrame))) return false;
+    tape->stack[tape->depth].index = tape->count;
+    tape->stack[tape->depth].count = 0;
+    tape->depth++;
+    return emit(tape, make_word(tag, 0));   // 结束时回填
+}
+
+// 回填开始标记：结束标记之后的位置和成员数
+static bool tape_end(JsonTape* tape, char tag) {
+    const TapeFrame* frame = &tape->stack[--tape->depth];
+    size_t after = tape->count + 1;
+    if (after > TAPE_INDEX_MASK) {
+        json_set_error(JSON_ERROR_DOCUMENT_TOO_LARGE);
+        return false;
+    }
+    uint64_t count = frame->count < TAPE_COUNT_MAX ? frame->count : TAPE_COUNT_MAX;
+    tape->words[frame->index] |= (count << 32) | after;
+    return emit(tape, make_word(tag, frame->index));
+}
+
+static bool tape_start_object(void* ctx) {
+    return tape_start((JsonTape*)ctx, '{');
+}
+
+static bool tape_end_object(void* ctx) {
+    return tape_end((JsonTape*)ctx, '}');
+}
+
+static bool tape_start_array(void* ctx) {
+    return tape_start((JsonTape*)ctx, '[');
+}
+
+static bool tape_end_array(void* ctx) {
+    return tape_end((JsonTape*)ctx, ']');
+}
+
+// 字符串内容追加到字符串缓冲区
+static bool tape_emit_string(JsonTape* tape, const char* str, size_t len) {
+    size_t offset = tape->strings_len;
+    size_t need = offset + sizeof(size_t) + len + 1;
+    if (!reserve((void**)&tape->strings, &tape->strings_cap, need, 1)) return false;
+    memcpy(tape->strings + offset, &len, sizeof(size_t));
+    memcpy(tape->strings + offset + sizeof(size_t), str, len);
+    tape->strings[need - 1] = '\0';
+    tape->strings_len = need;
+    return emit(tape, make_word('"', offset));
+}
+
+static bool tape_key(void* ctx, const char* key, size_t len) {
+    JsonTape* tape = (JsonTape*)ctx;
+    tape->stack[tape->depth - 1].count++;
+    return tape_emit_string(tape, key, len);
+}
+
+static bool tape_string(void* ctx, const char* str, size_t len) {
+    JsonTape* tape = (JsonTape*)ctx;
+    count_value(tape);
+    return tape_emit_string(tape, str, len);
+}
+
+// 数字占两个字：类型标记和值
+static bool tape_emit_number(JsonTape* tape, char tag, uint64_t bits) {
+    count_value(tape);
+    return emit(tape, make_word(tag, 0)) && emit(tape, bits);
+}
+
+static bool tape_number(void* ctx, const JsonNumber* number) {
+    JsonTape* tape = (JsonTape*)ctx;
+    char tag = 'd';
+    uint64_t bits;
+    if ((tape->flags & JSON_PARSE_INT64) && number->kind == JSON_NUMBER_INT64) {
+        tag = 'l';
+        bits = (uint64_t)number->value.i;
+    } else if ((tape->flags & JSON_PARSE_INT64) && number->kind == JSON_NUMBER_UINT64) {
+        tag = 'u';
+        bits = number->value.u;
+    } else {
+        double d = json_number_to_double(number);
+        memcpy(&bits, &d, sizeof(double));
+    }
+    return tape_emit_number(tape, tag, bits);
+}
+
+static bool tape_boolean(void* ctx, bool value) {
+    JsonTape* tape = (JsonTape*)ctx;
+    count_value(tape);
+    return emit(tape, make_word(value ? 't' : 'f', 0));
+}
+
+static bool tape_null(void* ctx) {
+    JsonTape* tape = (JsonTape*)ctx;
+    count_value(tape);
+    return emit(tape, make_word('n', 0));
+}
+
+static const JsonHandler tape_handler = {
+    tape_start_object,
+    tape_end_object,
+    tape_start_array,
+    tape_end_array,
+    tape_key,
+    tape_string,
+    NULL,               // 数字由tape_number接收
+    tape_boolean,
+    tape_null
+};
+
+JsonTape* json_tape_create(void) {
+    JsonTape* tape = (JsonTape*)json_calloc(NULL, 1, sizeof(JsonTape));
+    if (!tape) json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+    return tape;
+}
+
+void json_tape_free(JsonTape* tape) {
+    if (!tape) return;
+    if (tape->read_only) {
+        if (tape->mapping) json_unmap_file(tape->mapping, tape->mapping_size);
+        json_free(NULL, tape);
+        return;
+    }
+    json_free(NULL, tape->words);
+    json_free(NULL, tape->strings);
+    json_free(NULL, tape->stack);
+    json_free(NULL, tape);
+}
+
+// 首次解析时按输入长度预估容量，之后复用上次的缓冲区
+bool json_tape_parse(JsonTape* tape, const char* json, size_t len, unsigned flags) {
+    if (!tape || !json || tape->read_only) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return false;
+    }
+    if (flags & ~(unsigned)JSON_PARSE_INT64) {
+        json_set_error(JSON_ERROR_INVALID_FLAGS);
+        return false;
+    }
+    tape->count = 0;
+    tape->strings_len = 0;
+    tape->depth = 0;
+    tape->flags = flags;
+    if (!reserve((void**)&tape->words, &tape->capacity, len / 8 + 1, sizeof(uint64_t))) return false;
+
+    if (!json_parse_events_exact(json, len, &tape_handler, tape_number, tape)) {
+        tape->count = 0;
+        tape->strings_len = 0;
+        return false;
+    }
+    return true;
+}
+
+JsonTape* json_parse_tape(const char* json, size_t len, unsigned flags) {
+    JsonTape* tape = json_tape_create();
+    if (!tape) return NULL;
+    if (!json_tape_parse(tape, json, len, flags)) {
+        json_tape_free(tape);
+        return NULL;
+    }
+    return tape;
+}
+
+size_t json_tape_word_count(const JsonTape* tape) {
+    return tape ? tape->count : 0;
+}
+
+// 按值树的结构依次写入磁带
+static bool tape_emit_value(JsonTape* tape, const JsonValue* value) {
+    uint64_t bits;
+    switch (value->type) {
+        case JSON_OBJECT:
+            if (!tape_start(tape, '{')) return false;
+            for (size_t i = 0; i < value->value.object->size; i++) {
+                const JsonKeyValue* pair = &value->value.object->pairs[i];
+                if (!tape_key(tape, pair->key, pair->key_length) || !tape_emit_value(tape, pair->value)) return false;
+            }
+            return tape_end(tape, '}');
+        case JSON_ARRAY:
+            if (!tape_start(tape, '[')) return false;
+            for (size_t i = 0; i < value->value.array->size; i++) {
+                if (!tape_emit_value(tape, value->value.array->elements[i])) return false;
+            }
+            return tape_end(tape, ']');
+        case JSON_STRING:
+            return tape_string(tape, value->value.string, value->length);
+        case JSON_NUMBER:
+            memcpy(&bits, &value->value.number, sizeof(double));
+            return tape_emit_number(tape, 'd', bits);
+        case JSON_INT64:
+            return tape_emit_number(tape, 'l', value->value.uint64);
+        case JSON_UINT64:
+            return tape_emit_number(tape, 'u', value->value.uint64);
+        case JSON_BOOL:
+            return tape_boolean(tape, value->value.boolean);
+        default:
+            return tape_null(tape);
+    }
+}
+
+JsonTape* json_tape_from_value(const JsonValue* value) {
+    if (!value) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+    JsonTape* tape = json_tape_create();
+    if (!tape) return NULL;
+    tape->flags = JSON_PARSE_INT64;
+    if (!tape_emit_value(tape, value)) {
+        json_tape_free(tape);
+        return NULL;
+    }
+    return tape;
+}
+
+// ---------- 读取 ----------
+
+static const JsonTapeRef missing = {NULL, 0};
+
+static uint64_t ref_word(JsonTapeRef ref) {
+    return ref.tape->words[ref.index];
+}
+
+JsonTapeRef json_tape_root(const JsonTape* tape) {
+    if (!tape || tape->count == 0) return missing;
+    JsonTapeRef ref = {tape, 0};
+    return ref;
+}
+
+// 紧随该值之后的位置：容器直接跳到结束标记之后，数字跳过值所在的字
+static size_t skip_value(const JsonTape* tape, size_t index) {
+    uint64_t word = tape->words[index];
+    switch (word_tag(word)) {
+        case '{':
+        case '[':
+            return (size_t)(word & TAPE_INDEX_MASK);
+        case 'l':
+        case 'u':
+        case 'd':
+            return index + 2;
+        default:
+            return index + 1;
+    }
+}
+
+JsonValueType json_tape_type(JsonTapeRef ref) {
+    if (!ref.tape) return JSON_NULL;
+    switch (word_tag(ref_word(ref))) {
+        case '{': return JSON_OBJECT;
+        case '[': return JSON_ARRAY;
+        case '"': return JSON_STRING;
+        case 'l': return JSON_INT64;
+        case 'u': return JSON_UINT64;
+        case 'd': return JSON_NUMBER;
+        case 't':
+        case 'f': return JSON_BOOL;
+        default: return JSON_NULL;
+    }
+}
+
+bool json_tape_get_bool(JsonTapeRef ref) {
+    return ref.tape && word_tag(ref_word(ref)) == 't';
+}
+
+// 数字转换为JsonValue后沿用json_value_get_*的转换规则
+static bool number_value(JsonTapeRef ref, JsonValue* value) {
+    if (!ref.tape) return false;
+    value->type = json_tape_type(ref);
+    uint64_t bits = ref.tape->words[ref.index + 1];
+    switch (value->type) {
+        case JSON_INT64: value->value.int64 = (int64_t)bits; return true;
+        case JSON_UINT64: value->value.uint64 = bits; return true;
+        case JSON_NUMBER: memcpy(&value->value.number, &bits, sizeof(double)); return true;
+        default: return false;
+    }
+}
+
+double json_tape_get_number(JsonTapeRef ref) {
+    JsonValue value;
+    return number_value(ref, &value) ? json_value_get_number(&value) : 0.0;
+}
+
+int64_t json_tape_get_int64(JsonTapeRef ref) {
+    JsonValue value;
+    return number_value(ref, &value) ? json_value_get_int64(&value) : 0;
+}
+
+uint64_t json_tape_get_uint64(JsonTapeRef ref) {
+    JsonValue value;
+    return number_value(ref, &value) ? json_value_get_uint64(&value) : 0;
+}
+
+const char* json_tape_get_string(JsonTapeRef ref, size_t* length) {
+    if (!ref.tape || word_tag(ref_word(ref)) != '"') {
+        if (length) *length = 0;
+        return NULL;
+    }
+    const char* entry = ref.tape->strings + (ref_word(ref) & TAPE_PAYLOAD_MASK);
+    if (length) memcpy(length, entry, sizeof(size_t));
+    return entry + sizeof(size_t);
+}
+
+JsonTapeIter json_tape_iter(JsonTapeRef container) {
+    JsonTapeIter iter = {NULL, 0, 0};
+    if (!container.tape) return iter;
+    char tag = word_tag(ref_word(container));
+    if (tag != '{' && tag != '[') return iter;
+    iter.tape = container.tape;
+    iter.index = container.index + 1;
+    iter.end = skip_value(container.tape, container.index) - 1;
+    return iter;
+}
+
+bool json_tape_array_next(JsonTapeIter* iter, JsonTapeRef* value) {
+    if (!iter->tape || iter->index >= iter->end) return false;
+    value->tape = iter->tape;
+    value->index = iter->index;
+    iter->index = skip_value(iter->tape, iter->index);
+    return true;
+}
+
+bool json_tape_object_next(JsonTapeIter* iter, const char** key, size_t* key_length, JsonTapeRef* value) {
+    if (!iter->tape || iter->index >= iter->end) return false;
+    JsonTapeRef key_ref = {iter->tape, iter->index};
+    const char* k = json_tape_get_string(key_ref, key_length);
+    if (key) *key = k;
+    value->tape = iter->tape;
+    value->index = iter->index + 1;
+    iter->index = skip_value(iter->tape, iter->index + 1);
+    return true;
+}
+
+size_t json_tape_size(JsonTapeRef ref) {
+    if (!ref.tape) return 0;
+    uint64_t word = ref_word(ref);
+    char tag = word_tag(word);
+    if (tag != '{' && tag != '[') return 0;
+
+    size_t count = (size_t)((word >> 32) & TAPE_COUNT_MAX);
+    if (count < TAPE_COUNT_MAX) return count;
+
+    // 成员数超出字段范围时逐个跳过计数
+    JsonTapeIter iter = json_tape_iter(ref);
+    JsonTapeRef value;
+    count = 0;
+    if (tag == '[') {
+        while (json_tape_array_next(&iter, &value)) count++;
+    } else {
+        while (json_tape_object_next(&iter, NULL, NULL, &value)) count++;
+    }
+    return count;
+}
+
+// 字符串区offset处的字符串
+static const char* tape_string_at(const char* strings, size_t offset, size_t* length) {
+    memcpy(length, strings + offset, sizeof(size_t));
+    return strings + offset + sizeof(size_t);
+}
+
+// 快照中容器的查找表，没有时返回NULL：按容器位置二分查找目录
+static const uint32_t* container_table(const JsonTape* tape, size_t index) {
+    size_t lo = 0, hi = tape->directory_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        size_t at = tape->directory[mid * 2];
+        if (at == index) return tape->tables + tape->directory[mid * 2 + 1];
+        if (at < index) lo = mid + 1;
+        else hi = mid;
+    }
+    return NULL;
+}
+
+JsonTapeRef json_tape_array_get(JsonTapeRef array, size_t index) {
+    if (!array.tape || word_tag(ref_word(array)) != '[') return missing;
+    const uint32_t* table = array.tape->directory_count ? container_table(array.tape, array.index) : NULL;
+    if (table) {
+        if (index >= table[0]) return missing;
+        JsonTapeRef value = {array.tape, table[1 + index]};
+        return value;
+    }
+    JsonTapeIter iter = json_tape_iter(array);
+    JsonTapeRef value;
+    while (json_tape_array_next(&iter, &value)) {
+        if (index-- == 0) return value;
+    }
+    return missing;
+}
+
+JsonTapeRef json_tape_object_get(JsonTapeRef object, const char* key, size_t key_length) {
+    if (!object.tape || !key || word_tag(ref_word(object)) != '{') return missing;
+    const uint32_t* table = object.tape->directory_count ? container_table(object.tape, object.index) : NULL;
+    if (table) {
+        size_t mask = table[0] - 1;
+        size_t slot = json_hash_key(key, key_length) & mask;
+        for (; table[1 + slot]; slot = (slot + 1) & mask) {
+            size_t k_len;
+            const char* k = tape_string_at(object.tape->strings,
+                                           (size_t)(object.tape->words[table[1 + slot] - 1] & TAPE_PAYLOAD_MASK), &k_len);
+            if (k_len == key_length && memcmp(k, key, key_length) == 0) {
+                JsonTapeRef value = {object.tape, table[1 + slot]};
+                return value;
+            }
+        }
+        return missing;
+    }
+    JsonTapeIter iter = json_tape_iter(object);
+    const char* k;
+    size_t k_len;
+    JsonTapeRef value;
+    while (json_tape_object_next(&iter, &k, &k_len, &value)) {
+        if (k_len == key_length && memcmp(k, key, key_length) == 0) return value;
+    }
+    return missing;
+}
+
+// ---------- 快照 ----------
+
+// 快照遍历中打开的容器
+typedef struct {
+    size_t next;        // 下一个成员的位置
+    size_t end;         // 结束标记的位置
+    bool object;
+} SnapshotFrame;
+
+// 生成快照的中间状态：复制的磁带中字符串偏移改写为新字符串区中的偏移
+typedef struct {
+    const JsonTape* tape;
+    uint64_t* words;
+    char* strings;
+    size_t strings_len;
+    size_t strings_cap;
+    uint64_t* keys;             // 键字典：开放寻址，槽位存放键在新字符串区中的偏移+1
+    size_t key_slots;
+    size_t key_count;
+    uint32_t* directory;
+    size_t directory_len;       // uint32_t个数
+    size_t directory_cap;
+    uint32_t* tables;
+    size_t tables_len;
+    size_t tables_cap;
+    SnapshotFrame* stack;
+    size_t depth;
+    size_t stack_cap;
+} SnapshotWriter;
+
+// 把字符串追加到新字符串区，返回其偏移
+static bool snapshot_append(SnapshotWriter* w, const char* str, size_t len, size_t* offset) {
+    *offset = w->strings_len;
+    size_t need = w->strings_len + sizeof(size_t) + len + 1;
+    if (!reserve((void**)&w->strings, &w->strings_cap, need, 1)) return false;
+    memcpy(w->strings + *offset, &len, sizeof(size_t));
+    memcpy(w->strings + *offset + sizeof(size_t), str, len);
+    w->strings[need - 1] = '\0';
+    w->strings_len = need;
+    return true;
+}
+
+// 在键字典中查找或插入键，装载因子超过0.5时扩容
+static bool snapshot_intern(SnapshotWriter* w, const char* key, size_t len, size_t* offset) {
+    if ((w->key_count + 1) * 2 > w->key_slots) {
+        size_t slots = w->key_slots ? w->key_slots * 2 : 256;
+        uint64_t* keys = (uint64_t*)json_calloc(NULL, slots, sizeof(uint64_t));
+        if (!keys) {
+            json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+            return false;
+        }
+        for (size_t i = 0; i < w->key_slots; i++) {
+            if (!w->keys[i]) continue;
+            size_t k_len;
+            const char* k = tape_string_at(w->strings, (size_t)(w->keys[i] - 1), &k_len);
+            size_t slot = json_hash_key(k, k_len) & (slots - 1);
+            while (keys[slot]) slot = (slot + 1) & (slots - 1);
+            keys[slot] = w->keys[i];
+        }
+        json_free(NULL, w->keys);
+        w->keys = keys;
+        w->key_slots = slots;
+    }
+
+    size_t mask = w->key_slots - 1;
+    size_t slot = json_hash_key(key, len) & mask;
+    for (; w->keys[slot]; slot = (slot + 1) & mask) {
+        size_t k_len;
+        const char* k = tape_string_at(w->strings, (size_t)(w->keys[slot] - 1), &k_len);
+        if (k_len == len && memcmp(k, key, len) == 0) {
+            *offset = (size_t)(w->keys[slot] - 1);
+            return true;
+        }
+    }
+    if (!snapshot_append(w, key, len, offset)) return false;
+    w->keys[slot] = (uint64_t)*offset + 1;
+    w->key_count++;
+    return true;
+}
+
+// 改写index处字符串的偏移；键经过字典去重
+static bool snapshot_string(SnapshotWriter* w, size_t index, bool key) {
+    size_t len;
+    const char* str = tape_string_at(w->tape->strings, (size_t)(w->tape->words[index] & TAPE_PAYLOAD_MASK), &len);
+    size_t offset;
+    if (!(key ? snapshot_intern(w, str, len, &offset) : snapshot_append(w, str, len, &offset))) return false;
+    w->words[index] = make_word('"', offset);
+    return true;
+}
+
+// 为成员较多的容器建立查找表并登记到目录：
+// 数组表为[元素数, 各元素位置...]，对象表为[槽位数, 各槽位键的位置+1...]
+static bool snapshot_table(SnapshotWriter* w, size_t index) {
+    JsonTapeRef ref = {w->tape, index};
+    size_t size = json_tape_size(ref);
+    if (size < JSON_TAPE_TABLE_MIN_SIZE) return true;
+
+    bool object = word_tag(w->tape->words[index]) == '{';
+    size_t slots = size;
+    if (object) {
+        slots = 1;
+        while (slots < size * 2) slots <<= 1;
+    }
+    size_t offset = w->tables_len;
+    if (offset + 1 + slots > UINT32_MAX) {
+        json_set_error(JSON_ERROR_DOCUMENT_TOO_LARGE);
+        return false;
+    }
+    if (!reserve((void**)&w->tables, &w->tables_cap, offset + 1 + slots, sizeof(uint32_t)) ||
+        !reserve((void**)&w->directory, &w->directory_cap, w->directory_len + 2, sizeof(uint32_t))) {
+        return false;
+    }
+    uint32_t* table = w->tables + offset;
+    table[0] = (uint32_t)slots;
+    memset(table + 1, 0, sizeof(uint32_t) * slots);
+
+    JsonTapeIter iter = json_tape_iter(ref);
+    JsonTapeRef value;
+    size_t i = 0;
+    if (object) {
+        const char* key;
+        size_t key_length;
+        while (json_tape_object_next(&iter, &key, &key_length, &value)) {
+            size_t slot = json_hash_key(key, key_length) & (slots - 1);
+            while (table[1 + slot]) slot = (slot + 1) & (slots - 1);
+            table[1 + slot] = (uint32_t)value.index;   // 键的位置+1即值的位置
+        }
+    } else {
+        while (json_tape_array_next(&iter, &value)) table[1 + i++] = (uint32_t)value.index;
+    }
+
+    w->tables_len = offset + 1 + slots;
+    w->directory[w->directory_len++] = (uint32_t)index;
+    w->directory[w->directory_len++] = (uint32_t)offset;
+    return true;
+}
+
+// 处理index处的值：改写字符串偏移，容器建立查找表后入栈
+static bool snapshot_value(SnapshotWriter* w, size_t index) {
+    char tag = word_tag(w->tape->words[index]);
+    if (tag == '"') return snapshot_string(w, index, false);
+    if (tag != '{' && tag != '[') return true;
+
+    if (!snapshot_table(w, index)) return false;
+    if (!reserve((void**)&w->stack, &w->stack_cap, w->depth + 1, sizeof(SnapshotFrame))) return false;
+    SnapshotFrame* frame = &w->stack[w->depth++];
+    frame->next = index + 1;
+    frame->end = skip_value(w->tape, index) - 1;
+    frame->object = tag == '{';
+    return true;
+}
+
+// 按结构遍历磁带（数字的值字不能当作标记解释）
+static bool snapshot_walk(SnapshotWriter* w) {
+    if (!snapshot_value(w, 0)) return false;
+    while (w->depth > 0) {
+        SnapshotFrame* top = &w->stack[w->depth - 1];
+        if (top->next >= top->end) {
+            w->depth--;
+            continue;
+        }
+        size_t index = top->next;
+        if (top->object && !snapshot_string(w, index++, true)) return false;
+        top->next = skip_value(w->tape, index);
+        if (!snapshot_value(w, index)) return false;
+    }
+    return true;
+}
+
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+void* json_tape_snapshot(const JsonTape* tape, size_t* size) {
+    if (!tape || tape->count == 0 || !size) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    SnapshotWriter w;
+    memset(&w, 0, sizeof(w));
+    w.tape = tape;
+    w.words = (uint64_t*)json_malloc(NULL, sizeof(uint64_t) * tape->count);
+    char* buffer = NULL;
+    if (!w.words) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        goto done;
+    }
+    memcpy(w.words, tape->words, sizeof(uint64_t) * tape->count);
+    if (!snapshot_walk(&w)) goto done;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.size_bytes = (uint32_t)sizeof(size_t);
+    header.word_count = tape->count;
+    header.strings_len = w.strings_len;
+    header.directory_count = w.directory_len / 2;
+    header.tables_len = w.tables_len;
+
+    size_t words_at = sizeof(SnapshotHeader);
+    size_t strings_at = words_at + sizeof(uint64_t) * tape->count;
+    size_t directory_at = strings_at + align8(w.strings_len);
+    size_t tables_at = directory_at + sizeof(uint32_t) * w.directory_len;
+    *size = tables_at + sizeof(uint32_t) * w.tables_len;
+    buffer = (char*)json_calloc(NULL, 1, *size);
+    if (!buffer) {
+        json_set_error(JSON_ERROR_OUT_OF_MEMORY);
+        goto done;
+    }
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + words_at, w.words, sizeof(uint64_t) * tape->count);
+    if (w.strings_len) memcpy(buffer + strings_at, w.strings, w.strings_len);
+    if (w.directory_len) memcpy(buffer + directory_at, w.directory, sizeof(uint32_t) * w.directory_len);
+    if (w.tables_len) memcpy(buffer + tables_at, w.tables, sizeof(uint32_t) * w.tables_len);
+
+done:
+    json_free(NULL, w.words);
+    json_free(NULL, w.strings);
+    json_free(NULL, w.keys);
+    json_free(NULL, w.directory);
+    json_free(NULL, w.tables);
+    json_free(NULL, w.stack);
+    return buffer;
+}
+
+bool json_tape_save(const JsonTape* tape, const char* path) {
+    size_t size;
+    void* buffer = json_tape_snapshot(tape, &size);
+    if (!buffer) return false;
+
+    FILE* file = fopen(path, "wb");
+    bool ok = file && fwrite(buffer, 1, size, file) == size;
+    if (file && fclose(file) != 0) ok = false;
+    json_free(NULL, buffer);
+    if (!ok) json_set_error(JSON_ERROR_FILE_WRITE);
+    return ok;
+}
+
+// 加载时校验中打开的容器
+typedef struct {
+    size_t index;               // 开始标记的位置
+    size_t end;                 // 结束标记的位置
+    size_t members;
+    const uint32_t* table;      // 查找表，没有时为NULL
+    bool object;
+    bool value_next;            // 对象中已读到键，下一个应为值
+} SnapshotCheck;
+
+// index处的字符串须完整落在字符串区内并以'\0'结尾
+static bool check_string(const JsonTape* tape, size_t index) {
+    size_t offset = (size_t)(tape->words[index] & TAPE_PAYLOAD_MASK);
+    if (offset > tape->strings_len || tape->strings_len - offset < sizeof(size_t) + 1) return false;
+    size_t len;
+    memcpy(&len, tape->strings + offset, sizeof(size_t));
+    if (len > tape->strings_len - offset - sizeof(size_t) - 1) return false;
+    return tape->strings[offset + sizeof(size_t) + len] == '\0';
+}
+
+// 开始标记：结束位置须在父容器之内；目录按容器位置升序，next_table依次对应遇到的容器
+static bool check_open(const JsonTape* tape, size_t index, size_t limit, SnapshotCheck* frame, size_t* next_table) {
+    uint64_t word = tape->words[index];
+    size_t after = (size_t)(word & TAPE_INDEX_MASK);
+    if (after < index + 2 || after > limit) return false;
+    frame->index = index;
+    frame->end = after - 1;
+    frame->members = 0;
+    frame->table = NULL;
+    frame->object = word_tag(word) == '{';
+    frame->value_next = false;
+    if (*next_table < tape->directory_count && tape->directory[*next_table * 2] == index) {
+        size_t offset = tape->directory[*next_table * 2 + 1];
+        if (offset >= tape->tables_len) return false;
+        size_t slots = tape->tables[offset];
+        if (slots > tape->tables_len - offset - 1) return false;
+        if (frame->object && (slots == 0 || (slots & (slots - 1)) != 0)) return false;
+        frame->table = tape->tables + offset;
+        (*next_table)++;
+    }
+    return true;
+}
+
+// 对象查找表中须能按键探测到该成员的值
+static bool check_slot(const JsonTape* tape, const uint32_t* table, size_t value) {
+    size_t key_length;
+    const char* key = tape_string_at(tape->strings, (size_t)(tape->words[value - 1] & TAPE_PAYLOAD_MASK), &key_length);
+    size_t mask = table[0] - 1;
+    size_t slot = json_hash_key(key, key_length) & mask;
+    for (size_t n = 0; n < table[0] && table[1 + slot]; n++, slot = (slot + 1) & mask) {
+        if (table[1 + slot] == value) return true;
+    }
+    return false;
+}
+
+// 结束标记须与开始标记互相指向，成员数与查找表一致；
+// 对象表的非空槽位数等于成员数（每个成员已各自探测到），且至少留一个空槽位保证查找能结束
+static bool check_close(const JsonTape* tape, const SnapshotCheck* frame) {
+    uint64_t word = tape->words[frame->end];
+    if (word_tag(word) != (frame->object ? '}' : ']') || (word & TAPE_PAYLOAD_MASK) != frame->index) return false;
+    if (frame->value_next) return false;
+    size_t count = (size_t)((tape->words[frame->index] >> 32) & TAPE_COUNT_MAX);
+    if (count < TAPE_COUNT_MAX ? count != frame->members : frame->members < TAPE_COUNT_MAX) return false;
+    if (!frame->table) return true;
+    if (!frame->object) return frame->table[0] == frame->members;
+    size_t used = 0;
+    for (size_t i = 0; i < frame->table[0]; i++) {
+        if (frame->table[1 + i]) used++;
+    }
+    return used == frame->members && used < frame->table[0];
+}
+
+// 按结构顺序扫描一遍磁带，O(字数+查找表)：字符串在字符串区内，开始和结束标记互相指向且正确嵌套，
+// 数字的值字不越过容器，目录只登记容器且查找表的每一项都是该容器的成员
+static bool snapshot_check(const JsonTape* tape) {
+    if (tape->count > TAPE_INDEX_MASK) return false;
+    SnapshotCheck* stack = NULL;
+    size_t depth = 0;
+    size_t stack_cap = 0;
+    size_t next_table = 0;
+    size_t index = 0;
+    bool ok = false;
+
+    for (;;) {
+        SnapshotCheck* top = depth ? &stack[depth - 1] : NULL;
+        if (top && index == top->end) {
+            if (!check_close(tape, top)) goto done;
+            index++;
+            if (--depth == 0) break;
+            continue;
+        }
+        char tag = word_tag(tape->words[index]);
+        if (top && top->object && !top->value_next) {
+            if (tag != '"' || !check_string(tape, index)) goto done;
+            top->members++;
+            top->value_next = true;
+            index++;
+            continue;
+        }
+        if (top && top->object) {
+            top->value_next = false;
+            if (top->table && !check_slot(tape, top->table, index)) goto done;
+        } else if (top) {
+            if (top->table && (top->members >= top->table[0] || top->table[1 + top->members] != index)) goto done;
+            top->members++;
+        }
+
+        switch (tag) {
+            case '{':
+            case '[':
+                if (!reserve((void**)&stack, &stack_cap, depth + 1, sizeof(SnapshotCheck))) goto done;
+                if (!check_open(tape, index, top ? top->end : tape->count, &stack[depth], &next_table)) goto done;
+                depth++;
+                index++;
+                continue;
+            case '"':
+                if (!check_string(tape, index)) goto done;
+                index++;
+                break;
+            case 'l':
+            case 'u':
+            case 'd':
+                index += 2;
+                break;
+            case 't':
+            case 'f':
+            case 'n':
+                index++;
+                break;
+            default:
+                goto done;
+        }
+        if (!top) break;                    // 根是标量
+        if (index > top->end) goto done;    // 数字的值字占了结束标记
+    }
+    ok = index == tape->count && next_table == tape->directory_count;
+
+done:
+    json_free(NULL, stack);
+    return ok;
+}
+
+// 检查头部和各区的范围，再扫描一遍磁带校验其中的偏移，之后直接指向快照内容
+JsonTape* json_tape_load_buffer(const void* data, size_t size) {
+    if (!data || ((uintptr_t)data & 7) != 0) {
+        json_set_error(JSON_ERROR_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    SnapshotHeader header;
+    if (size < sizeof(header)) goto invalid;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.byte_order != SNAPSHOT_BYTE_ORDER || header.size_bytes != sizeof(size_t)) {
+        goto invalid;
+    }
+
+    size_t rest = size - sizeof(header);
+    if (header.word_count == 0 || header.word_count > rest / sizeof(uint64_t)) goto invalid;
+    rest -= (size_t)header.word_count * sizeof(uint64_t);
+    if (header.strings_len > rest || align8((size_t)header.strings_len) > rest) goto invalid;
+    rest -= align8((size_t)header.strings_len);
+    if (header.directory_count > rest / (2 * sizeof(uint32_t))) goto invalid;
+    rest -= (size_t)header.directory_count * 2 * sizeof(uint32_t);
+    // 用除法比较，避免tables_len * 4在64位上回绕
+    if (rest % sizeof(uint32_t) != 0 || header.tables_len != rest / sizeof(uint32_t)) goto invalid;
+
+    JsonTape* tape = json_tape_create();
+    if (!tape) return NULL;
+    const char* base = (const char*)data + sizeof(header);
+    tape->words = (uint64_t*)base;
+    tape->count = (size_t)header.word_count;
+    base += tape->count * sizeof(uint64_t);
+    tape->strings = (char*)base;
+    tape->strings_len = (size_t)header.strings_len;
+    base += align8(tape->strings_len);
+    tape->directory = (const uint32_t*)base;
+    tape->directory_count = (size_t)header.directory_count;
+    tape->tables = tape->directory + tape->directory_count * 2;
+    tape->tables_len = (size_t)header.tables_len;
+    tape->read_only = true;
+    if (!snapshot_check(tape)) {
+        json_tape_free(tape);
+        goto invalid;
+    }
+    return tape;
+
+invalid:
+    json_set_error(JSON_ERROR_SNAPSHOT_FORMAT);
+    return NULL;
+}
+
+JsonTape* json_tape_load(const char* path) {
+    size_t size = 0;
+    void* mapping = json_map_file(path, JSON_PARSE_DEFAULT, &size);
+    if (!mapping) return NULL;
+
+    JsonTape* tape = json_tape_load_buffer(mapping, size);
+    if (!tape) {
+        json_unmap_file(mapping, size);
+        return NULL;
+    }
+    tape->mapping = mapping;
+    tape->mapping_size = size;
+    return tape;
+}
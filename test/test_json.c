@@ -4,6 +4,11 @@
 #include "unity.h"
 #include "json_builder.h"
 #include "json_parser.h"
+#include "json_ndjson.h"
+#include "json_tape.h"
+#include "json_cursor.h"
+#include "json_path.h"
+#include "json_parallel.h"
 
 // 测试JSON构建器的基本功能
 void test_json_builder_basic() {
@@ -301,6 +306,1609 @@ void test_json_deep_nesting() {
     json_builder_free(builder);
 }
 
+// 测试内存池文档模式
+void test_json_document_arena() {
+    const char* json_str = "{\"name\":\"张三\",\"scores\":[1,2,3,4,5,6,7,8,9,10],\"info\":{\"city\":\"北京\"}}";
+
+    JsonDocument* doc = json_parse_into(NULL, json_str);
+    TEST_ASSERT_NOT_NULL(doc);
+    JsonObject* obj = json_value_get_object(json_document_root(doc));
+    TEST_ASSERT_NOT_NULL(obj);
+    TEST_ASSERT_EQUAL_INT(3, (int)obj->size);
+    TEST_ASSERT_EQUAL_STRING("张三", json_value_get_string(obj->pairs[0].value));
+    JsonArray* scores = json_value_get_array(obj->pairs[1].value);
+    TEST_ASSERT_NOT_NULL(scores);
+    TEST_ASSERT_EQUAL_INT(10, (int)scores->size);
+    TEST_ASSERT_EQUAL_INT(10, (int)json_value_get_number(scores->elements[9]));
+    json_document_free(doc);
+
+    // 调用方持有的内存池可以在多次解析之间重置复用
+    JsonArena* arena = json_arena_create(256);
+    TEST_ASSERT_NOT_NULL(arena);
+    for (int i = 0; i < 3; i++) {
+        doc = json_parse_into(arena, json_str);
+        TEST_ASSERT_NOT_NULL(doc);
+        obj = json_value_get_object(json_document_root(doc));
+        TEST_ASSERT_EQUAL_STRING("city", json_value_get_object(obj->pairs[2].value)->pairs[0].key);
+        json_arena_reset(arena);
+    }
+    TEST_ASSERT_NULL(json_parse_into(arena, "[1,2"));
+    json_arena_free(arena);
+}
+
+// 测试空白和转义密集的大输入：空白跳过和字符串扫描跨越多个向量块
+void test_json_whitespace_heavy() {
+    JsonBuilder* builder = json_builder_create(1024);
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT(json_builder_append(builder, "[\n"));
+    bool ok = true;
+    for (int i = 0; i < 1000; i++) {
+        ok = ok && json_builder_append(builder, i ? " ,\n\t{ " : "\t{ ");
+        ok = ok && json_builder_append(builder, "\"msg\" :\t\"含有 \\\"引号\\\" 和 [括号] {, :}\\\\\" ,\r\n");
+        ok = ok && json_builder_append(builder, "  \"list\" : [ 1 , -2.5 , true , null ] }");
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(json_builder_append(builder, "\n]  "));
+    const char* json_str = json_builder_get_string(builder);
+    TEST_ASSERT(strlen(json_str) >= 64 * 1024);
+
+    JsonValue* value = json_parse(json_str);
+    TEST_ASSERT_NOT_NULL(value);
+    JsonArray* array = json_value_get_array(value);
+    TEST_ASSERT_NOT_NULL(array);
+    TEST_ASSERT_EQUAL_INT(1000, (int)array->size);
+    JsonObject* last = json_value_get_object(array->elements[999]);
+    TEST_ASSERT_EQUAL_STRING("含有 \"引号\" 和 [括号] {, :}\\", json_value_get_string(last->pairs[0].value));
+    JsonArray* list = json_value_get_array(last->pairs[1].value);
+    TEST_ASSERT_EQUAL_INT(4, (int)list->size);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001, -2.5, json_value_get_number(list->elements[1]));
+    TEST_ASSERT_EQUAL_INT(JSON_NULL, list->elements[3]->type);
+    json_value_free(value);
+
+    // 跳过空白后仍需检测记号之间的非法字符
+    TEST_ASSERT_NULL(json_parse("[1, 2 x, 3]"));
+
+    json_builder_free(builder);
+}
+
+// 测试长字符串的向量化扫描及跨越向量边界的转义
+void test_json_long_strings() {
+    char json_str[512];
+    char expected[512];
+
+    // 无转义的长字符串走整段复制路径
+    size_t n = 0;
+    json_str[n++] = '[';
+    json_str[n++] = '"';
+    for (int i = 0; i < 300; i++) {
+        json_str[n++] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i % 64];
+    }
+    memcpy(expected, json_str + 2, 300);
+    expected[300] = '\0';
+    strcpy(json_str + n, "\"                                      ]");
+
+    JsonValue* value = json_parse(json_str);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING(expected, json_value_get_string(json_value_get_array(value)->elements[0]));
+    json_value_free(value);
+
+    // 转义序列落在16/32字节边界两侧
+    for (int offset = 12; offset < 36; offset++) {
+        n = 0;
+        json_str[n++] = '"';
+        memset(json_str + n, 'x', offset);
+        n += offset;
+        strcpy(json_str + n, "\\\"\\\\\\nyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy\"");
+
+        memset(expected, 'x', offset);
+        strcpy(expected + offset, "\"\\\nyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyy");
+
+        value = json_parse(json_str);
+        if (!value || strcmp(expected, json_value_get_string(value)) != 0) {
+            TEST_ASSERT_EQUAL_STRING(expected, value ? json_value_get_string(value) : "");
+        }
+        json_value_free(value);
+    }
+
+    // 未结束的长字符串
+    TEST_ASSERT_NULL(json_parse("\"abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz\\\""));
+}
+
+// 测试原地解析：字符串直接指向输入缓冲区
+void test_json_parse_insitu() {
+    char buffer[] = "{\"name\":\"张三\",\"path\":\"a\\\\b\\n\\\"c\\\"\",\"tags\":[\"x\",\"\"]}";
+    size_t buffer_len = strlen(buffer);
+
+    JsonDocument* doc = json_parse_insitu(NULL, buffer);
+    TEST_ASSERT_NOT_NULL(doc);
+    JsonObject* obj = json_value_get_object(json_document_root(doc));
+    TEST_ASSERT_NOT_NULL(obj);
+    TEST_ASSERT_EQUAL_INT(3, (int)obj->size);
+
+    // 键和无转义的字符串都是输入缓冲区的视图
+    TEST_ASSERT(obj->pairs[0].key == buffer + 2);
+    TEST_ASSERT_EQUAL_INT(4, (int)obj->pairs[0].key_length);
+    const char* name = json_value_get_string(obj->pairs[0].value);
+    TEST_ASSERT(name > buffer && name < buffer + buffer_len);
+    TEST_ASSERT_EQUAL_STRING("张三", name);
+    TEST_ASSERT_EQUAL_INT(6, (int)json_value_get_string_length(obj->pairs[0].value));
+
+    // 含转义的字符串在缓冲区内原地解码
+    const char* path = json_value_get_string(obj->pairs[1].value);
+    TEST_ASSERT(path > buffer && path < buffer + buffer_len);
+    TEST_ASSERT_EQUAL_STRING("a\\b\n\"c\"", path);
+    TEST_ASSERT_EQUAL_INT(7, (int)json_value_get_string_length(obj->pairs[1].value));
+
+    JsonArray* tags = json_value_get_array(obj->pairs[2].value);
+    TEST_ASSERT_EQUAL_INT(2, (int)tags->size);
+    TEST_ASSERT_EQUAL_STRING("", json_value_get_string(tags->elements[1]));
+    json_document_free(doc);
+}
+
+// 测试按长度解析：输入不需要以'\0'结尾
+void test_json_parse_length_delimited() {
+    const char* frame = "{\"id\":12345,\"ok\":true,\"tags\":[\"a\",null]}{\"next\":1}";
+    size_t first_len = strlen("{\"id\":12345,\"ok\":true,\"tags\":[\"a\",null]}");
+
+    JsonValue* value = json_parse_n(frame, first_len);
+    TEST_ASSERT_NOT_NULL(value);
+    JsonObject* obj = json_value_get_object(value);
+    TEST_ASSERT_EQUAL_INT(3, (int)obj->size);
+    TEST_ASSERT_EQUAL_INT(12345, (int)json_value_get_number(obj->pairs[0].value));
+    json_value_free(value);
+
+    // 精确大小的缓冲区，末尾没有'\0'
+    const char* inputs[] = { "123", "-4.5e2", "true", "false", "null", "\"abc\"", "[1,2]" };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        size_t len = strlen(inputs[i]);
+        char* exact = (char*)malloc(len);
+        memcpy(exact, inputs[i], len);
+        value = json_parse_n(exact, len);
+        TEST_ASSERT_NOT_NULL(value);
+        json_value_free(value);
+        free(exact);
+    }
+
+    // 截断在字面量、数字和字符串中间的输入必须失败或只读取len范围内的数据
+    TEST_ASSERT_NULL(json_parse_n("true", 3));
+    TEST_ASSERT_NULL(json_parse_n("null", 2));
+    TEST_ASSERT_NULL(json_parse_n("\"abc\"", 4));
+    TEST_ASSERT_NULL(json_parse_n("[1,2]", 4));
+    value = json_parse_n("12345", 3);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_INT(123, (int)json_value_get_number(value));
+    json_value_free(value);
+
+    JsonDocument* doc = json_parse_into_n(NULL, frame + first_len, strlen(frame) - first_len);
+    TEST_ASSERT_NOT_NULL(doc);
+    TEST_ASSERT_EQUAL_STRING("next", json_value_get_object(json_document_root(doc))->pairs[0].key);
+    json_document_free(doc);
+}
+
+// 测试文件映射解析
+void test_json_parse_file() {
+    const char* path = "test_parse_file.json";
+    const char* content = "{\"name\":\"张三\",\"escaped\":\"a\\tb\",\"list\":[1,2,3]}\n";
+    FILE* file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    fwrite(content, 1, strlen(content), file);
+    fclose(file);
+
+    unsigned modes[] = { JSON_PARSE_DEFAULT, JSON_PARSE_VIEWS, JSON_PARSE_INSITU };
+    for (int i = 0; i < 3; i++) {
+        JsonDocument* doc = json_parse_file(path, modes[i]);
+        TEST_ASSERT_NOT_NULL(doc);
+        JsonObject* obj = json_value_get_object(json_document_root(doc));
+        TEST_ASSERT_EQUAL_INT(3, (int)obj->size);
+
+        // 只读视图模式下字符串不以'\0'结尾，按长度比较
+        JsonValue* name = obj->pairs[0].value;
+        TEST_ASSERT_EQUAL_INT(6, (int)json_value_get_string_length(name));
+        TEST_ASSERT(memcmp("张三", json_value_get_string(name), 6) == 0);
+        TEST_ASSERT(obj->pairs[1].key_length == 7 && memcmp("escaped", obj->pairs[1].key, 7) == 0);
+        TEST_ASSERT_EQUAL_STRING("a\tb", json_value_get_string(obj->pairs[1].value));
+        TEST_ASSERT_EQUAL_INT(3, (int)json_value_get_array(obj->pairs[2].value)->size);
+        json_document_free(doc);
+    }
+
+    // 原地模式使用私有映射，不会修改文件本身
+    file = fopen(path, "rb");
+    char buffer[128] = {0};
+    TEST_ASSERT(fread(buffer, 1, sizeof(buffer) - 1, file) == strlen(content));
+    fclose(file);
+    TEST_ASSERT_EQUAL_STRING(content, buffer);
+
+    remove(path);
+    TEST_ASSERT_NULL(json_parse_file(path, JSON_PARSE_DEFAULT));
+}
+
+// 测试增量解析：逐字节送入，块边界落在字符串、转义和数字内部
+void test_json_push_parser() {
+    const char* json_str = "{\"name\":\"张三\",\"quote\":\"a\\\"b\\\\c\\n\",\"scores\":[100,-98.5,1e3],\"ok\":true,\"none\":null,\"empty\":{}}";
+    size_t len = strlen(json_str);
+
+    JsonParser* parser = json_parser_create_push();
+    TEST_ASSERT_NOT_NULL(parser);
+    JsonFeedStatus status = JSON_FEED_NEED_MORE;
+    size_t complete_at = 0;
+    for (size_t i = 0; i < len; i++) {
+        status = json_parser_feed(parser, json_str + i, 1);
+        if (status != JSON_FEED_NEED_MORE) {
+            complete_at = i + 1;
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_COMPLETE, status);
+    TEST_ASSERT(complete_at == len);
+
+    JsonValue* value = json_parser_take_value(parser);
+    TEST_ASSERT_NOT_NULL(value);
+    JsonObject* obj = json_value_get_object(value);
+    TEST_ASSERT_EQUAL_INT(6, (int)obj->size);
+    TEST_ASSERT_EQUAL_STRING("张三", json_value_get_string(obj->pairs[0].value));
+    TEST_ASSERT_EQUAL_STRING("a\"b\\c\n", json_value_get_string(obj->pairs[1].value));
+    JsonArray* scores = json_value_get_array(obj->pairs[2].value);
+    TEST_ASSERT_EQUAL_INT(3, (int)scores->size);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001, -98.5, json_value_get_number(scores->elements[1]));
+    TEST_ASSERT_FLOAT_WITHIN(0.00001, 1000.0, json_value_get_number(scores->elements[2]));
+    TEST_ASSERT(json_value_get_bool(obj->pairs[3].value));
+    TEST_ASSERT_EQUAL_STRING("empty", obj->pairs[5].key);
+    json_value_free(value);
+    json_parser_free(parser);
+
+    // 顶层数字在输入结束时才算完整
+    parser = json_parser_create_push();
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_NEED_MORE, json_parser_feed(parser, "12", 2));
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_NEED_MORE, json_parser_feed(parser, "34", 2));
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_COMPLETE, json_parser_finish(parser));
+    value = json_parser_take_value(parser);
+    TEST_ASSERT_EQUAL_INT(1234, (int)json_value_get_number(value));
+    json_value_free(value);
+    json_parser_free(parser);
+
+    // 截断的输入在结束时报告错误，未取走的部分结果随解析器释放
+    parser = json_parser_create_push();
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_NEED_MORE, json_parser_feed(parser, "{\"key\":\"val", 12));
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_ERROR, json_parser_finish(parser));
+    TEST_ASSERT_NULL(json_parser_take_value(parser));
+    json_parser_free(parser);
+
+    parser = json_parser_create_push();
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_ERROR, json_parser_feed(parser, "[1,]", 4));
+    json_parser_free(parser);
+}
+
+// 事件回调测试用的统计上下文
+typedef struct {
+    int objects;
+    int arrays;
+    int strings;
+    double price_sum;
+    bool in_price;
+    int limit;      // 大于0时，第limit个数字事件中止解析
+    int numbers;
+} EventStats;
+
+static bool stats_start_object(void* ctx) {
+    ((EventStats*)ctx)->objects++;
+    return true;
+}
+
+static bool stats_start_array(void* ctx) {
+    ((EventStats*)ctx)->arrays++;
+    return true;
+}
+
+static bool stats_key(void* ctx, const char* key, size_t len) {
+    ((EventStats*)ctx)->in_price = len == 5 && memcmp(key, "price", 5) == 0;
+    return true;
+}
+
+static bool stats_string(void* ctx, const char* str, size_t len) {
+    (void)str;
+    (void)len;
+    ((EventStats*)ctx)->strings++;
+    return true;
+}
+
+static bool stats_number(void* ctx, double value) {
+    EventStats* stats = (EventStats*)ctx;
+    if (stats->in_price) stats->price_sum += value;
+    stats->in_price = false;
+    return ++stats->numbers != stats->limit;
+}
+
+// 测试事件驱动解析：只统计需要的字段，不创建值树
+void test_json_parse_events() {
+    const char* json_str = "[{\"name\":\"apple\",\"price\":1.5,\"tags\":[\"a\\\"b\",\"c\"]},"
+                           "{\"name\":\"pear\",\"price\":2,\"stock\":10,\"sale\":false,\"note\":null}]";
+    JsonHandler handler = {0};
+    handler.start_object = stats_start_object;
+    handler.start_array = stats_start_array;
+    handler.key = stats_key;
+    handler.string = stats_string;
+    handler.number = stats_number;
+
+    EventStats stats = {0};
+    TEST_ASSERT(json_parse_events(json_str, strlen(json_str), &handler, &stats));
+    TEST_ASSERT_EQUAL_INT(2, stats.objects);
+    TEST_ASSERT_EQUAL_INT(2, stats.arrays);
+    TEST_ASSERT_EQUAL_INT(4, stats.strings);
+    TEST_ASSERT_EQUAL_INT(3, stats.numbers);
+    TEST_ASSERT_FLOAT_WITHIN(0.00001, 3.5, stats.price_sum);
+
+    // 回调返回false时中止解析
+    EventStats aborted = {0};
+    aborted.limit = 2;
+    TEST_ASSERT(!json_parse_events(json_str, strlen(json_str), &handler, &aborted));
+    TEST_ASSERT_EQUAL_INT(2, aborted.numbers);
+    TEST_ASSERT_EQUAL_STRING("解析被回调中止", json_get_error());
+
+    // 语法错误照常报告
+    EventStats invalid = {0};
+    TEST_ASSERT(!json_parse_events("{\"price\":1,}", 13, &handler, &invalid));
+}
+
+// 测试NDJSON并行解析：结果按输入顺序返回，失败的记录单独报告
+void test_json_parse_ndjson() {
+    size_t count = 200;
+    size_t cap = count * 64;
+    char* ndjson = (char*)malloc(cap);
+    TEST_ASSERT_NOT_NULL(ndjson);
+    size_t len = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 137) {
+            len += sprintf(ndjson + len, "{\"id\":137,\"bad\":}\n");
+        } else {
+            len += sprintf(ndjson + len, "{\"id\":%d,\"name\":\"record %d\"}\r\n", (int)i, (int)i);
+        }
+        if (i % 50 == 0) len += sprintf(ndjson + len, "  \n");   // 空白行不计为记录
+    }
+
+    JsonNdjsonBatch* batch = json_parse_ndjson(ndjson, len, 4);
+    TEST_ASSERT_NOT_NULL(batch);
+    TEST_ASSERT_EQUAL_INT((int)count, (int)batch->count);
+    TEST_ASSERT_EQUAL_INT(1, (int)batch->error_count);
+    TEST_ASSERT_NULL(batch->documents[137]);
+    TEST_ASSERT_NOT_NULL(batch->errors[137]);
+    // 错误偏移相对整个输入，指向坏记录中的'}'
+    JsonError record_error = batch->record_errors[137];
+    TEST_ASSERT(record_error.code != JSON_ERROR_NONE);
+    TEST_ASSERT(record_error.offset < len);
+    TEST_ASSERT_EQUAL_INT('}', ndjson[record_error.offset]);
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_NONE, batch->record_errors[136].code);
+    bool ordered = true;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 137) continue;
+        JsonObject* obj = json_value_get_object(json_document_root(batch->documents[i]));
+        if (!obj || (size_t)json_value_get_number(obj->pairs[0].value) != i) ordered = false;
+    }
+    TEST_ASSERT(ordered);
+    json_ndjson_batch_free(batch);
+
+    // 流式迭代器：边解析边按顺序取出
+    JsonNdjsonIter* iter = json_ndjson_iter_create(ndjson, len, 3);
+    TEST_ASSERT_NOT_NULL(iter);
+    JsonDocument* doc;
+    size_t seen = 0;
+    size_t failed = 0;
+    ordered = true;
+    while (json_ndjson_iter_next(iter, &doc)) {
+        if (!doc) {
+            failed++;
+            if (seen != 137 || !json_ndjson_iter_error(iter)) ordered = false;
+            JsonError e = json_ndjson_iter_last_error(iter);
+            if (e.code != record_error.code || e.offset != record_error.offset) ordered = false;
+        } else {
+            if (json_ndjson_iter_last_error(iter).code != JSON_ERROR_NONE) ordered = false;
+            JsonObject* obj = json_value_get_object(json_document_root(doc));
+            if ((size_t)json_value_get_number(obj->pairs[0].value) != seen) ordered = false;
+        }
+        seen++;
+    }
+    TEST_ASSERT(ordered);
+    TEST_ASSERT_EQUAL_INT((int)count, (int)seen);
+    TEST_ASSERT_EQUAL_INT(1, (int)failed);
+    json_ndjson_iter_free(iter);
+
+    // 提前释放迭代器
+    iter = json_ndjson_iter_create(ndjson, len, 2);
+    TEST_ASSERT(json_ndjson_iter_next(iter, &doc));
+    json_ndjson_iter_free(iter);
+    free(ndjson);
+}
+
+// 测试按键查找：小对象线性扫描，大对象使用解析时建立的哈希索引
+void test_json_object_get() {
+    JsonValue* value = json_parse("{\"name\":\"张三\",\"age\":25,\"a\\\"b\":1,\"age\":26}");
+    TEST_ASSERT_NOT_NULL(value);
+    JsonObject* obj = json_value_get_object(value);
+    TEST_ASSERT_NULL(obj->index);
+    TEST_ASSERT_EQUAL_STRING("张三", json_value_get_string(json_object_get(obj, "name", 4)));
+    TEST_ASSERT_EQUAL_INT(25, (int)json_value_get_number(json_object_get(obj, "age", 3)));
+    TEST_ASSERT_NOT_NULL(json_object_get(obj, "a\"b", 3));
+    TEST_ASSERT_NULL(json_object_get(obj, "nam", 3));
+    TEST_ASSERT_NULL(json_object_get(obj, "names", 5));
+    json_value_free(value);
+
+    // 200个成员的对象，另有一个重复的键
+    char* json_str = (char*)malloc(200 * 40);
+    TEST_ASSERT_NOT_NULL(json_str);
+    size_t len = sprintf(json_str, "{");
+    for (int i = 0; i < 200; i++) {
+        len += sprintf(json_str + len, "\"field_with_long_name_%d\":%d,", i, i);
+    }
+    len += sprintf(json_str + len, "\"field_with_long_name_7\":-1}");
+
+    value = json_parse(json_str);
+    TEST_ASSERT_NOT_NULL(value);
+    obj = json_value_get_object(value);
+    TEST_ASSERT_NOT_NULL(obj->index);
+    bool found = true;
+    char key[64];
+    for (int i = 0; i < 200; i++) {
+        int key_length = sprintf(key, "field_with_long_name_%d", i);
+        if ((int)json_value_get_number(json_object_get(obj, key, key_length)) != i) found = false;
+    }
+    TEST_ASSERT(found);
+    TEST_ASSERT_NULL(json_object_get(obj, "field_with_long_name_200", 24));
+
+    // 文档模式和增量解析得到的对象同样带有索引
+    JsonDocument* doc = json_parse_into_n(NULL, json_str, len);
+    TEST_ASSERT_NOT_NULL(doc);
+    obj = json_value_get_object(json_document_root(doc));
+    TEST_ASSERT_NOT_NULL(obj->index);
+    TEST_ASSERT_EQUAL_INT(123, (int)json_value_get_number(json_object_get(obj, "field_with_long_name_123", 24)));
+    json_document_free(doc);
+
+    JsonParser* parser = json_parser_create_push();
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_COMPLETE, json_parser_feed(parser, json_str, len));
+    JsonValue* pushed = json_parser_take_value(parser);
+    obj = json_value_get_object(pushed);
+    TEST_ASSERT_NOT_NULL(obj->index);
+    TEST_ASSERT_EQUAL_INT(7, (int)json_value_get_number(json_object_get(obj, "field_with_long_name_7", 22)));
+    json_value_free(pushed);
+    json_parser_free(parser);
+
+    json_value_free(value);
+    free(json_str);
+}
+
+// 测试数字解析：整数精确保存、正确舍入以及严格的JSON数字语法
+void test_json_parse_int64() {
+    const char* json_str = "[9007199254740993,-9223372036854775808,18446744073709551615,"
+                           "18446744073709551616,1.5,-0,123]";
+
+    // 默认模式下所有数字都是double
+    JsonValue* value = json_parse(json_str);
+    TEST_ASSERT_NOT_NULL(value);
+    JsonArray* arr = json_value_get_array(value);
+    TEST_ASSERT_EQUAL_INT(JSON_NUMBER, arr->elements[0]->type);
+    TEST_ASSERT(arr->elements[0]->value.number == 9007199254740992.0);
+    json_value_free(value);
+
+    value = json_parse_ex(json_str, strlen(json_str), JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(value);
+    arr = json_value_get_array(value);
+    TEST_ASSERT_EQUAL_INT(JSON_INT64, arr->elements[0]->type);
+    TEST_ASSERT(json_value_get_int64(arr->elements[0]) == 9007199254740993LL);
+    TEST_ASSERT_EQUAL_INT(JSON_INT64, arr->elements[1]->type);
+    TEST_ASSERT(json_value_get_int64(arr->elements[1]) == INT64_MIN);
+    TEST_ASSERT_EQUAL_INT(JSON_UINT64, arr->elements[2]->type);
+    TEST_ASSERT(json_value_get_uint64(arr->elements[2]) == UINT64_MAX);
+    TEST_ASSERT_EQUAL_INT(JSON_NUMBER, arr->elements[3]->type);
+    TEST_ASSERT_EQUAL_INT(JSON_NUMBER, arr->elements[4]->type);
+    TEST_ASSERT_EQUAL_INT(JSON_NUMBER, arr->elements[5]->type);
+    TEST_ASSERT(json_value_is_number(arr->elements[6]));
+    TEST_ASSERT_FLOAT_WITHIN(0.00001, 123.0, json_value_get_number(arr->elements[6]));
+    json_value_free(value);
+
+    JsonDocument* doc = json_parse_into_ex(NULL, "{\"id\":1234567890123456789}", 26, JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(doc);
+    JsonValue* id = json_object_get(json_value_get_object(json_document_root(doc)), "id", 2);
+    TEST_ASSERT(json_value_get_int64(id) == 1234567890123456789LL);
+    json_document_free(doc);
+
+    // 结果与正确舍入一致，包括需要回退的边界值
+    value = json_parse("[0.1,2.2250738585072011e-308,1.7976931348623157e308,4.9e-324,"
+                       "3.141592653589793238462643383279,1e400]");
+    TEST_ASSERT_NOT_NULL(value);
+    arr = json_value_get_array(value);
+    TEST_ASSERT(arr->elements[0]->value.number == 0.1);
+    TEST_ASSERT(arr->elements[1]->value.number == 2.2250738585072009e-308);
+    TEST_ASSERT(arr->elements[2]->value.number == 1.7976931348623157e308);
+    TEST_ASSERT(arr->elements[3]->value.number == 4.9406564584124654e-324);
+    TEST_ASSERT(arr->elements[4]->value.number == 3.141592653589793);
+    TEST_ASSERT(isinf(arr->elements[5]->value.number));
+    json_value_free(value);
+
+    // 非法的数字
+    TEST_ASSERT_NULL(json_parse("01"));
+    TEST_ASSERT_NULL(json_parse("1."));
+    TEST_ASSERT_NULL(json_parse("-"));
+    TEST_ASSERT_NULL(json_parse("[1e]"));
+    TEST_ASSERT_NULL(json_parse("[.5]"));
+    TEST_ASSERT_NULL(json_parse_ex("1", 1, JSON_PARSE_VIEWS));
+}
+
+// 测试数字格式化：最短且能精确还原的表示，整数和64位整数按整数输出
+void test_json_builder_number_format() {
+    JsonBuilder* builder = json_builder_create(16);
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_number(builder, "a", 0.1));
+    TEST_ASSERT(json_builder_add_number(builder, "b", 1.0 / 3));
+    TEST_ASSERT(json_builder_add_number(builder, "c", -42));
+    TEST_ASSERT(json_builder_add_number(builder, "d", 1e21));
+    TEST_ASSERT(json_builder_add_number(builder, "e", 1.5e-7));
+    TEST_ASSERT(json_builder_add_number(builder, "f", 5e-324));
+    TEST_ASSERT(json_builder_add_number(builder, "g", 0.001234));
+    TEST_ASSERT(json_builder_add_number(builder, "h", 1e300 * 1e300));
+    TEST_ASSERT(json_builder_add_int64(builder, "i", INT64_MIN));
+    TEST_ASSERT(json_builder_add_uint64(builder, "j", UINT64_MAX));
+    TEST_ASSERT(json_builder_end_object(builder));
+    TEST_ASSERT_EQUAL_STRING("{\"a\":0.1,\"b\":0.3333333333333333,\"c\":-42,\"d\":1e21,\"e\":1.5e-7,"
+                             "\"f\":5e-324,\"g\":0.001234,\"h\":null,\"i\":-9223372036854775808,"
+                             "\"j\":18446744073709551615}", json_builder_get_string(builder));
+    json_builder_free(builder);
+
+    // 需要17位有效数字的值也能精确还原
+    double samples[] = {0.1 + 0.2, 1.7976931348623157e308, 2.2250738585072014e-308, 123456789.123456789, -9007199254740993.0};
+    bool exact = true;
+    for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+        builder = json_builder_create(64);
+        json_builder_start_object(builder);
+        json_builder_add_number(builder, "v", samples[i]);
+        json_builder_end_object(builder);
+        JsonValue* value = json_parse(json_builder_get_string(builder));
+        JsonValue* v = json_object_get(json_value_get_object(value), "v", 1);
+        if (!v || json_value_get_number(v) != samples[i]) exact = false;
+        json_value_free(value);
+        json_builder_free(builder);
+    }
+    TEST_ASSERT(exact);
+}
+
+// 测试带长度的构建接口：键值可以不以'\0'结尾，超过1KB的键值对不会溢出
+void test_json_builder_length_variants() {
+    JsonBuilder* builder = json_builder_create(8);
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_string_n(builder, "name_ignored", 4, "a\"b\\c\nd\te\rXYZ", 10));
+    TEST_ASSERT(json_builder_add_number_n(builder, "pi_", 2, 3.25));
+    TEST_ASSERT(json_builder_add_int64_n(builder, "id", 2, -7));
+    TEST_ASSERT(json_builder_add_bool_n(builder, "okay", 2, false));
+    TEST_ASSERT(json_builder_add_null_n(builder, "nil", 3));
+    TEST_ASSERT(json_builder_end_object(builder));
+    TEST_ASSERT_EQUAL_STRING("{\"name\":\"a\\\"b\\\\c\\nd\\te\\r\",\"pi\":3.25,\"id\":-7,\"ok\":false,\"nil\":null}",
+                             json_builder_get_string(builder));
+    json_builder_free(builder);
+
+    size_t long_len = 5000;
+    char* long_value = (char*)malloc(long_len + 1);
+    TEST_ASSERT_NOT_NULL(long_value);
+    for (size_t i = 0; i < long_len; i++) long_value[i] = (i % 100 == 0) ? '"' : 'x';
+    long_value[long_len] = '\0';
+
+    builder = json_builder_create(16);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_string(builder, "long", long_value));
+    TEST_ASSERT(json_builder_end_object(builder));
+    JsonValue* value = json_parse(json_builder_get_string(builder));
+    TEST_ASSERT_NOT_NULL(value);
+    JsonValue* parsed = json_object_get(json_value_get_object(value), "long", 4);
+    TEST_ASSERT_EQUAL_INT((int)long_len, (int)json_value_get_string_length(parsed));
+    TEST_ASSERT(memcmp(json_value_get_string(parsed), long_value, long_len) == 0);
+    json_value_free(value);
+    json_builder_free(builder);
+    free(long_value);
+}
+
+// 测试字符串转义：全部控制字符、键的转义以及可选的\u转义
+void test_json_builder_escape() {
+    JsonBuilder* builder = json_builder_create(16);
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_string_n(builder, "ctl", 3, "a\0b\x01\b\f\x1f\x7f", 8));
+    TEST_ASSERT(json_builder_add_string(builder, "k\"ey", "张三"));
+    TEST_ASSERT(json_builder_end_object(builder));
+    TEST_ASSERT_EQUAL_STRING("{\"ctl\":\"a\\u0000b\\u0001\\b\\f\\u001f\x7f\",\"k\\\"ey\":\"张三\"}",
+                             json_builder_get_string(builder));
+
+    // 输出能被解析器读回
+    JsonValue* value = json_parse(json_builder_get_string(builder));
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_NOT_NULL(json_object_get(json_value_get_object(value), "k\"ey", 4));
+    json_value_free(value);
+    json_builder_free(builder);
+
+    // 仅ASCII输出：BMP字符、代理对和无效的UTF-8字节
+    builder = json_builder_create(16);
+    json_builder_set_flags(builder, JSON_BUILDER_ASCII);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_string(builder, "s", "张三\xF0\x9F\x98\x80x\xFF\xE4\xB8"));
+    TEST_ASSERT(json_builder_end_object(builder));
+    TEST_ASSERT_EQUAL_STRING("{\"s\":\"\\u5f20\\u4e09\\ud83d\\ude00x\\ufffd\\ufffd\\ufffd\"}",
+                             json_builder_get_string(builder));
+    json_builder_free(builder);
+
+    // 较长的干净字符串整段复制，中间的转义不影响前后内容
+    char long_value[300];
+    for (int i = 0; i < 299; i++) long_value[i] = (char)('a' + i % 26);
+    long_value[150] = '\n';
+    long_value[299] = '\0';
+    builder = json_builder_create(16);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_string(builder, "v", long_value));
+    TEST_ASSERT(json_builder_end_object(builder));
+    value = json_parse(json_builder_get_string(builder));
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING(long_value, json_value_get_string(json_object_get(json_value_get_object(value), "v", 1)));
+    json_value_free(value);
+    json_builder_free(builder);
+}
+
+// 逐字节送入增量解析器
+static JsonValue* push_parse_bytes(const char* json, size_t len) {
+    JsonParser* parser = json_parser_create_push();
+    JsonFeedStatus status = JSON_FEED_NEED_MORE;
+    for (size_t i = 0; i < len && status == JSON_FEED_NEED_MORE; i++) {
+        status = json_parser_feed(parser, json + i, 1);
+    }
+    if (status == JSON_FEED_NEED_MORE) status = json_parser_finish(parser);
+    JsonValue* value = status == JSON_FEED_COMPLETE ? json_parser_take_value(parser) : NULL;
+    json_parser_free(parser);
+    return value;
+}
+
+static void assert_string_value(const char* expected, size_t expected_len, JsonValue* value) {
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_INT((int)expected_len, (int)json_value_get_string_length(value));
+    TEST_ASSERT(memcmp(expected, json_value_get_string(value), expected_len) == 0);
+}
+
+void test_json_escape_roundtrip() {
+    // 0x00-0x1F、引号、反斜杠、斜杠和多字节UTF-8（含4字节字符）
+    char original[64];
+    size_t n = 0;
+    for (int c = 0; c < 0x20; c++) original[n++] = (char)c;
+    const char* tail = "\"\\/é张三\xF0\x9F\x98\x80";
+    memcpy(original + n, tail, strlen(tail));
+    n += strlen(tail);
+
+    unsigned modes[] = {JSON_BUILDER_DEFAULT, JSON_BUILDER_ASCII};
+    for (int m = 0; m < 2; m++) {
+        JsonBuilder* builder = json_builder_create(16);
+        json_builder_set_flags(builder, modes[m]);
+        TEST_ASSERT(json_builder_start_object(builder));
+        TEST_ASSERT(json_builder_add_string_n(builder, "s", 1, original, n));
+        TEST_ASSERT(json_builder_end_object(builder));
+        const char* json = json_builder_get_string(builder);
+        size_t len = strlen(json);
+
+        JsonValue* value = json_parse_n(json, len);
+        TEST_ASSERT_NOT_NULL(value);
+        assert_string_value(original, n, json_object_get(value->value.object, "s", 1));
+        json_value_free(value);
+
+        JsonDocument* doc = json_parse_into_n(NULL, json, len);
+        TEST_ASSERT_NOT_NULL(doc);
+        assert_string_value(original, n, json_object_get(json_document_root(doc)->value.object, "s", 1));
+        json_document_free(doc);
+
+        char insitu[512];
+        memcpy(insitu, json, len + 1);
+        doc = json_parse_insitu_n(NULL, insitu, len);
+        TEST_ASSERT_NOT_NULL(doc);
+        assert_string_value(original, n, json_object_get(json_document_root(doc)->value.object, "s", 1));
+        json_document_free(doc);
+
+        // 增量解析：转义和\uXXXX的十六进制数字跨块
+        value = push_parse_bytes(json, len);
+        TEST_ASSERT_NOT_NULL(value);
+        assert_string_value(original, n, json_object_get(value->value.object, "s", 1));
+        json_value_free(value);
+        json_builder_free(builder);
+    }
+
+    // 大小写十六进制和代理对
+    JsonValue* value = json_parse("\"\\u00E9\\u00e9\\uD83D\\ude00\\/\"");
+    assert_string_value("éé\xF0\x9F\x98\x80/", 9, value);
+    json_value_free(value);
+
+    // 无效转义：未知字符、十六进制不足或无效、单独的代理项
+    const char* invalid[] = {
+        "[\"ab\\x\"]", "[\"ab\\u12\"]", "[\"ab\\u12G4\"]", "[\"ab\\ud800\"]",
+        "[\"ab\\ud800\\u0041\"]", "[\"ab\\udc00\\ud800\"]", "[\"ab\\\"]"
+    };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        size_t len = strlen(invalid[i]);
+        TEST_ASSERT_NULL(json_parse_n(invalid[i], len));
+        if (i + 1 < sizeof(invalid) / sizeof(invalid[0])) {
+            TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_ESCAPE, json_get_last_error().code);
+            TEST_ASSERT_EQUAL_INT(4, (int)json_get_last_error().offset);
+        }
+        TEST_ASSERT_NULL(json_parse_into_n(NULL, invalid[i], len));
+        TEST_ASSERT_NULL(push_parse_bytes(invalid[i], len));
+    }
+}
+
+// 收集输出的回调
+typedef struct {
+    char data[4096];
+    size_t length;
+    int calls;
+    bool fail;
+} SinkOutput;
+
+static bool sink_collect(void* ctx, const char* data, size_t len) {
+    SinkOutput* out = (SinkOutput*)ctx;
+    if (out->fail || out->length + len >= sizeof(out->data)) return false;
+    memcpy(out->data + out->length, data, len);
+    out->length += len;
+    out->data[out->length] = '\0';
+    out->calls++;
+    return true;
+}
+
+// 构建一个跨越多次刷新的数组，包含放不下缓冲区的长字符串
+static void build_sink_document(JsonBuilder* builder, const char* long_value) {
+    json_builder_start_array(builder);
+    for (int i = 0; i < 8; i++) {
+        json_builder_start_object(builder);
+        json_builder_add_int64(builder, "id", i);
+        json_builder_add_string(builder, "name", "张三\n");
+        json_builder_end_object(builder);
+        json_builder_append(builder, ",");
+    }
+    json_builder_start_object(builder);
+    json_builder_add_string(builder, "long", long_value);
+    json_builder_end_object(builder);
+    json_builder_end_array(builder);
+}
+
+void test_json_builder_sink() {
+    char long_value[600];
+    for (int i = 0; i < 599; i++) long_value[i] = (char)('a' + i % 26);
+    long_value[300] = '"';
+    long_value[599] = '\0';
+
+    JsonBuilder* memory = json_builder_create(16);
+    build_sink_document(memory, long_value);
+    const char* expected = json_builder_get_string(memory);
+
+    // 回调：最小的缓冲区，输出与内存构建一致，末尾的逗号仍能被撤销
+    SinkOutput out = {{0}, 0, 0, false};
+    JsonBuilder* builder = json_builder_create_callback(sink_collect, &out, 1);
+    TEST_ASSERT_NOT_NULL(builder);
+    TEST_ASSERT_EQUAL_INT(JSON_BUILDER_SINK_MIN_BUFFER, (int)builder->capacity);
+    build_sink_document(builder, long_value);
+    TEST_ASSERT_NULL(json_builder_get_string(builder));
+    TEST_ASSERT(json_builder_flush(builder));
+    TEST_ASSERT_EQUAL_STRING(expected, out.data);
+    TEST_ASSERT(out.calls > 1);
+    TEST_ASSERT_EQUAL_INT(JSON_BUILDER_SINK_MIN_BUFFER, (int)builder->capacity);
+    json_builder_free(builder);
+
+    // 文件描述符和FILE*
+    FILE* file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    builder = json_builder_create_fd(fileno(file), 128);
+    build_sink_document(builder, long_value);
+    TEST_ASSERT(json_builder_flush(builder));
+    json_builder_free(builder);
+    builder = json_builder_create_file(file, 0);
+    build_sink_document(builder, long_value);
+    TEST_ASSERT(json_builder_flush(builder));
+    json_builder_free(builder);
+    fflush(file);
+
+    size_t expected_length = strlen(expected);
+    char* written = (char*)malloc(expected_length * 2 + 1);
+    rewind(file);
+    TEST_ASSERT_EQUAL_INT((int)(expected_length * 2), (int)fread(written, 1, expected_length * 2 + 1, file));
+    TEST_ASSERT(memcmp(written, expected, expected_length) == 0);
+    TEST_ASSERT(memcmp(written + expected_length, expected, expected_length) == 0);
+    free(written);
+    fclose(file);
+
+    // 写入失败后刷新一直返回false
+    SinkOutput failing = {{0}, 0, 0, true};
+    builder = json_builder_create_callback(sink_collect, &failing, 64);
+    build_sink_document(builder, long_value);
+    TEST_ASSERT(!json_builder_flush(builder));
+    failing.fail = false;
+    TEST_ASSERT(!json_builder_flush(builder));
+    json_builder_free(builder);
+
+    TEST_ASSERT_NULL(json_builder_create_fd(-1, 0));
+    TEST_ASSERT_NULL(json_builder_create_callback(NULL, NULL, 0));
+    json_builder_free(memory);
+}
+
+void test_json_value_serialize() {
+    const char* json = "{\"a\":[1,2.5,{},true],\"b\":{\"c\":null,\"d\":[]},\"e\":\"x\\ny\",\"big\":18446744073709551615}";
+    JsonValue* value = json_parse_ex(json, strlen(json), JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(value);
+
+    // 紧凑输出与输入相同，长度与预计算一致
+    size_t length = 0;
+    char* compact = json_value_to_string(value, JSON_SERIALIZE_COMPACT, &length);
+    TEST_ASSERT_EQUAL_STRING(json, compact);
+    TEST_ASSERT_EQUAL_INT((int)strlen(json), (int)length);
+    TEST_ASSERT_EQUAL_INT((int)length, (int)json_value_serialized_length(value, JSON_SERIALIZE_COMPACT));
+    free(compact);
+
+    // 美化输出：空容器保持在一行
+    char* pretty = json_value_to_string(value, JSON_SERIALIZE_PRETTY, &length);
+    TEST_ASSERT_EQUAL_STRING("{\n"
+                             "  \"a\": [\n"
+                             "    1,\n"
+                             "    2.5,\n"
+                             "    {},\n"
+                             "    true\n"
+                             "  ],\n"
+                             "  \"b\": {\n"
+                             "    \"c\": null,\n"
+                             "    \"d\": []\n"
+                             "  },\n"
+                             "  \"e\": \"x\\ny\",\n"
+                             "  \"big\": 18446744073709551615\n"
+                             "}", pretty);
+    TEST_ASSERT_EQUAL_INT((int)length, (int)json_value_serialized_length(value, JSON_SERIALIZE_PRETTY));
+    free(pretty);
+
+    // 写入构建器：与手写的键值对组合，ASCII选项只对本次序列化生效
+    JsonValue* name = json_parse("\"张三\"");
+    JsonBuilder* builder = json_builder_create(8);
+    TEST_ASSERT(json_builder_start_object(builder));
+    TEST_ASSERT(json_builder_add_value(builder, "doc", json_object_get(json_value_get_object(value), "b", 1), 0));
+    TEST_ASSERT(json_builder_add_value(builder, "ascii", name, JSON_SERIALIZE_ASCII));
+    TEST_ASSERT(json_builder_add_string(builder, "raw", "张三"));
+    TEST_ASSERT(json_builder_end_object(builder));
+    TEST_ASSERT_EQUAL_STRING("{\"doc\":{\"c\":null,\"d\":[]},\"ascii\":\"\\u5f20\\u4e09\",\"raw\":\"张三\"}",
+                             json_builder_get_string(builder));
+    json_builder_free(builder);
+
+    // 输出到目标
+    SinkOutput out = {{0}, 0, 0, false};
+    builder = json_builder_create_callback(sink_collect, &out, 64);
+    TEST_ASSERT(json_value_serialize(value, builder, JSON_SERIALIZE_COMPACT));
+    TEST_ASSERT(json_builder_flush(builder));
+    TEST_ASSERT_EQUAL_STRING(json, out.data);
+    json_builder_free(builder);
+
+    TEST_ASSERT(!json_value_serialize(NULL, NULL, 0));
+    TEST_ASSERT_NULL(json_value_to_string(NULL, 0, NULL));
+    json_value_free(name);
+    json_value_free(value);
+}
+
+// 逐节点比较两棵值树：类型、数值、字符串字节和成员顺序都相同
+static bool values_equal(const JsonValue* a, const JsonValue* b) {
+    if (a->type != b->type) return false;
+    switch (a->type) {
+        case JSON_NULL: return true;
+        case JSON_BOOL: return a->value.boolean == b->value.boolean;
+        case JSON_NUMBER: return a->value.number == b->value.number;
+        case JSON_INT64: return a->value.int64 == b->value.int64;
+        case JSON_UINT64: return a->value.uint64 == b->value.uint64;
+        case JSON_STRING:
+            return a->length == b->length && memcmp(a->value.string, b->value.string, a->length) == 0;
+        case JSON_ARRAY:
+            if (a->value.array->size != b->value.array->size) return false;
+            for (size_t i = 0; i < a->value.array->size; i++) {
+                if (!values_equal(a->value.array->elements[i], b->value.array->elements[i])) return false;
+            }
+            return true;
+        case JSON_OBJECT:
+            if (a->value.object->size != b->value.object->size) return false;
+            for (size_t i = 0; i < a->value.object->size; i++) {
+                const JsonKeyValue* x = &a->value.object->pairs[i];
+                const JsonKeyValue* y = &b->value.object->pairs[i];
+                if (x->key_length != y->key_length || memcmp(x->key, y->key, x->key_length) != 0) return false;
+                if (!values_equal(x->value, y->value)) return false;
+            }
+            return true;
+    }
+    return false;
+}
+
+void test_json_serialize_roundtrip() {
+    // 键和值中的各种转义、控制字符、\u编码的BMP字符和代理对
+    const char* json =
+        "{\"name\":\"caf\\u00e9\",\"emoji\":\"\\ud83d\\ude00!\",\"ctl\":\"a\\u0001\\b\\f\\n\\r\\t\\u001fz\","
+        "\"quote\":\"say \\\"hi\\\" \\\\ \\/path\",\"k\\u00e9y\\n\":[\"\\u5f20\\u4e09\",\"\",1.25,-7,"
+        "18446744073709551615,{\"nested\\t\":[true,false,null]}],\"raw\":\"张三\"}";
+    JsonValue* original = json_parse_ex(json, strlen(json), JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(original);
+    TEST_ASSERT_EQUAL_STRING("café", json_value_get_string(json_object_get(original->value.object, "name", 4)));
+    TEST_ASSERT_NOT_NULL(json_object_get(original->value.object, "k\xC3\xA9y\n", 5));
+
+    unsigned modes[] = {JSON_SERIALIZE_COMPACT, JSON_SERIALIZE_PRETTY, JSON_SERIALIZE_ASCII,
+                        JSON_SERIALIZE_PRETTY | JSON_SERIALIZE_ASCII};
+    for (int m = 0; m < 4; m++) {
+        size_t length = 0;
+        char* text = json_value_to_string(original, modes[m], &length);
+        TEST_ASSERT_NOT_NULL(text);
+        JsonValue* reparsed = json_parse_ex(text, length, JSON_PARSE_INT64);
+        TEST_ASSERT_NOT_NULL(reparsed);
+        TEST_ASSERT(values_equal(original, reparsed));
+
+        // 再次序列化得到相同的文本
+        char* again = json_value_to_string(reparsed, modes[m], NULL);
+        TEST_ASSERT_EQUAL_STRING(text, again);
+        free(again);
+        json_value_free(reparsed);
+        free(text);
+    }
+    json_value_free(original);
+}
+
+void test_json_tape() {
+    const char* json = "{\"id\":9007199254740993,\"name\":\"张三\\n\",\"tags\":[\"a\",[1,2],{}],\"ok\":true,\"none\":null,\"pi\":3.5}";
+    JsonTape* tape = json_parse_tape(json, strlen(json), JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(tape);
+    // 根对象2 + 键6 + 两个数字各2 + 字符串1 + ["a",[1,2],{}]共11 + true + null
+    TEST_ASSERT_EQUAL_INT(2 + 6 + 4 + 1 + 11 + 1 + 1, (int)json_tape_word_count(tape));
+
+    JsonTapeRef root = json_tape_root(tape);
+    TEST_ASSERT_EQUAL_INT(JSON_OBJECT, json_tape_type(root));
+    TEST_ASSERT_EQUAL_INT(6, (int)json_tape_size(root));
+
+    JsonTapeRef id = json_tape_object_get(root, "id", 2);
+    TEST_ASSERT_EQUAL_INT(JSON_INT64, json_tape_type(id));
+    TEST_ASSERT(json_tape_get_int64(id) == 9007199254740993LL);
+
+    size_t length;
+    TEST_ASSERT_EQUAL_STRING("张三\n", json_tape_get_string(json_tape_object_get(root, "name", 4), &length));
+    TEST_ASSERT_EQUAL_INT(7, (int)length);
+    TEST_ASSERT(json_tape_get_bool(json_tape_object_get(root, "ok", 2)));
+    TEST_ASSERT_EQUAL_INT(JSON_NULL, json_tape_type(json_tape_object_get(root, "none", 4)));
+    TEST_ASSERT_EQUAL_DOUBLE(3.5, json_tape_get_number(json_tape_object_get(root, "pi", 2)), 0.0001);
+    TEST_ASSERT_NULL(json_tape_object_get(root, "missing", 7).tape);
+
+    // 数组：下标访问会跳过前面的整个容器
+    JsonTapeRef tags = json_tape_object_get(root, "tags", 4);
+    TEST_ASSERT_EQUAL_INT(3, (int)json_tape_size(tags));
+    TEST_ASSERT_EQUAL_INT(JSON_OBJECT, json_tape_type(json_tape_array_get(tags, 2)));
+    TEST_ASSERT_EQUAL_INT(2, (int)json_tape_get_int64(json_tape_array_get(json_tape_array_get(tags, 1), 1)));
+    TEST_ASSERT_NULL(json_tape_array_get(tags, 3).tape);
+
+    // 按顺序遍历对象
+    JsonTapeIter iter = json_tape_iter(root);
+    const char* key;
+    size_t key_length;
+    JsonTapeRef value;
+    int members = 0;
+    while (json_tape_object_next(&iter, &key, &key_length, &value)) members++;
+    TEST_ASSERT_EQUAL_INT(6, members);
+    TEST_ASSERT_EQUAL_STRING("pi", key);
+
+    // 复用磁带解析新文档；没有JSON_PARSE_INT64时整数保存为double
+    TEST_ASSERT(json_tape_parse(tape, "[1, 2.5, \"x\"]", 13, JSON_PARSE_DEFAULT));
+    root = json_tape_root(tape);
+    TEST_ASSERT_EQUAL_INT(JSON_NUMBER, json_tape_type(json_tape_array_get(root, 0)));
+    iter = json_tape_iter(root);
+    double sum = 0;
+    while (json_tape_array_next(&iter, &value)) sum += json_tape_get_number(value);
+    TEST_ASSERT_EQUAL_DOUBLE(3.5, sum, 0.0001);
+
+    // 错误：磁带被清空
+    TEST_ASSERT(!json_tape_parse(tape, "[1, 2", 5, JSON_PARSE_DEFAULT));
+    TEST_ASSERT_NULL(json_tape_root(tape).tape);
+    TEST_ASSERT(!json_tape_parse(tape, "1", 1, JSON_PARSE_INSITU));
+    TEST_ASSERT_EQUAL_STRING("无效的解析选项", json_get_error());
+    TEST_ASSERT_NULL(json_parse_tape("{\"a\" 1}", 8, JSON_PARSE_DEFAULT));
+    json_tape_free(tape);
+}
+
+void test_json_cursor() {
+    // 前面的成员里有括号、转义引号和嵌套容器，都要被整段跳过
+    const char* json = "{\"skip\":[{\"s\":\"}]\\\"[\"},[[1],{}]],\"k\\\"q\":1,"
+                       "\"user\":{\"id\":9007199254740993,\"name\":\"张三\",\"bio\":\"a\\nb\",\"ok\":true},"
+                       "\"list\":[10, \"x\", null, 2.5]}";
+    JsonParser* parser = json_parser_create_lazy(json, strlen(json), JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(parser);
+    JsonCursor root = json_cursor_root(parser);
+    TEST_ASSERT_EQUAL_INT(JSON_OBJECT, json_cursor_type(root));
+
+    JsonCursor user = json_cursor_get(root, "user", 4);
+    TEST_ASSERT_EQUAL_INT(JSON_OBJECT, json_cursor_type(user));
+    JsonCursor id = json_cursor_get(user, "id", 2);
+    TEST_ASSERT_EQUAL_INT(JSON_INT64, json_cursor_type(id));
+    TEST_ASSERT(json_cursor_get_int64(id) == 9007199254740993LL);
+    TEST_ASSERT(json_cursor_get_bool(json_cursor_get(user, "ok", 2)));
+
+    // 无转义的字符串直接指向输入，含转义的解码到内存池
+    size_t length;
+    const char* name = json_cursor_get_string(json_cursor_get(user, "name", 4), &length);
+    TEST_ASSERT_EQUAL_INT(6, (int)length);
+    TEST_ASSERT(name > json && name < json + strlen(json));
+    TEST_ASSERT_EQUAL_STRING("a\nb", json_cursor_get_string(json_cursor_get(user, "bio", 3), &length));
+    TEST_ASSERT_EQUAL_INT(1, (int)json_cursor_get_int64(json_cursor_get(root, "k\"q", 3)));
+    TEST_ASSERT_NULL(json_cursor_get(root, "missing", 7).parser);
+
+    // 数组下标和遍历
+    JsonCursor list = json_cursor_get(root, "list", 4);
+    TEST_ASSERT_EQUAL_INT(JSON_NULL, json_cursor_type(json_cursor_at(list, 2)));
+    TEST_ASSERT_EQUAL_DOUBLE(2.5, json_cursor_get_number(json_cursor_at(list, 3)), 0.0001);
+    TEST_ASSERT_NULL(json_cursor_at(list, 4).parser);
+    JsonCursorIter iter = json_cursor_iter(root);
+    const char* key;
+    size_t key_length;
+    JsonCursor value;
+    int members = 0;
+    while (json_cursor_next(&iter, &key, &key_length, &value)) members++;
+    TEST_ASSERT_EQUAL_INT(4, members);
+    TEST_ASSERT_EQUAL_INT(4, (int)key_length);
+    TEST_ASSERT(memcmp(key, "list", 4) == 0);
+
+    // 把子树解析为JsonValue
+    JsonValue* tree = json_cursor_value(user);
+    TEST_ASSERT_NOT_NULL(tree);
+    TEST_ASSERT_EQUAL_STRING("张三", json_value_get_string(json_object_get(tree->value.object, "name", 4)));
+    json_parser_free(parser);
+
+    // 只校验被访问的部分：未结束的容器在跳过时报告
+    const char* bad = "{\"a\":[1,{\"b\":2},\"c\":3";
+    parser = json_parser_create_lazy(bad, strlen(bad), JSON_PARSE_DEFAULT);
+    TEST_ASSERT_NULL(json_cursor_get(json_cursor_root(parser), "c", 1).parser);
+    TEST_ASSERT_EQUAL_STRING("数组未正确结束", json_get_error());
+    json_parser_free(parser);
+    TEST_ASSERT_NULL(json_parser_create_lazy("1", 1, JSON_PARSE_INSITU));
+}
+
+void test_json_path() {
+    const char* json = "{\"a\":{\"b\":[0,1,2,{\"c\":\"x\"}]},\"m~n\":1,\"p/q\":2,\"\":3,"
+                       "\"users\":[{\"id\":7},{\"name\":\"n\"},{\"id\":9}]}";
+    JsonValue* root = json_parse(json);
+    TEST_ASSERT_NOT_NULL(root);
+
+    JsonPath* path = json_path_compile("/a/b/3/c", JSON_PATH_DEFAULT);
+    TEST_ASSERT_NOT_NULL(path);
+    TEST_ASSERT_EQUAL_INT(4, (int)json_path_segment_count(path));
+    TEST_ASSERT_EQUAL_STRING("x", json_value_get_string(json_path_get(path, root)));
+
+    // 同一个查询直接在原始输入上求值
+    JsonParser* parser = json_parser_create_lazy(json, strlen(json), JSON_PARSE_DEFAULT);
+    size_t length;
+    JsonCursor cursor = json_path_get_cursor(path, json_cursor_root(parser));
+    TEST_ASSERT_NOT_NULL(json_cursor_get_string(cursor, &length));
+    TEST_ASSERT_EQUAL_INT(1, (int)length);
+    json_path_free(path);
+
+    // ~0、~1转义，空键和根
+    path = json_path_compile("/m~0n", JSON_PATH_DEFAULT);
+    TEST_ASSERT_EQUAL_INT(1, (int)json_value_get_int64(json_path_get(path, root)));
+    json_path_free(path);
+    path = json_path_compile("/p~1q", JSON_PATH_DEFAULT);
+    TEST_ASSERT_EQUAL_INT(2, (int)json_cursor_get_int64(json_path_get_cursor(path, json_cursor_root(parser))));
+    json_path_free(path);
+    path = json_path_compile("/", JSON_PATH_DEFAULT);
+    TEST_ASSERT_EQUAL_INT(3, (int)json_value_get_int64(json_path_get(path, root)));
+    json_path_free(path);
+    path = json_path_compile("", JSON_PATH_DEFAULT);
+    TEST_ASSERT(json_path_get(path, root) == root);
+    json_path_free(path);
+
+    // 不存在：越界、前导0、对数组使用键
+    const char* missing[] = {"/a/b/4", "/a/b/01", "/a/b/-", "/a/x", "/users/id"};
+    for (size_t i = 0; i < sizeof(missing) / sizeof(missing[0]); i++) {
+        path = json_path_compile(missing[i], JSON_PATH_DEFAULT);
+        TEST_ASSERT_NULL(json_path_get(path, root));
+        TEST_ASSERT_NULL(json_path_get_cursor(path, json_cursor_root(parser)).parser);
+        json_path_free(path);
+    }
+
+    // 通配符：按文档顺序匹配，没有该成员的元素被跳过
+    path = json_path_compile("/users/*/id", JSON_PATH_WILDCARD);
+    JsonValue* results[4];
+    TEST_ASSERT_EQUAL_INT(2, (int)json_path_query(path, root, results, 4));
+    TEST_ASSERT_EQUAL_INT(7, (int)json_value_get_int64(results[0]));
+    TEST_ASSERT_EQUAL_INT(9, (int)json_value_get_int64(results[1]));
+    TEST_ASSERT_EQUAL_INT(7, (int)json_cursor_get_int64(json_path_get_cursor(path, json_cursor_root(parser))));
+    json_path_free(path);
+
+    // 格式错误
+    TEST_ASSERT_NULL(json_path_compile("a/b", JSON_PATH_DEFAULT));
+    TEST_ASSERT_EQUAL_STRING("JSON Pointer应以'/'开始", json_get_error());
+    TEST_ASSERT_NULL(json_path_compile("/a~2", JSON_PATH_DEFAULT));
+
+    json_parser_free(parser);
+    json_value_free(root);
+}
+
+void test_json_error_info() {
+    const char* json = "{\n  \"a\": [1, 2,\n  \"b\" 3]\n}";
+    size_t offset = (size_t)(strchr(json, '3') - json);
+
+    // 出错时只记录错误码和偏移，行号和列号按需计算
+    TEST_ASSERT_NULL(json_parse(json));
+    JsonError error = json_get_last_error();
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_EXPECTED_ARRAY_SEPARATOR, error.code);
+    TEST_ASSERT_EQUAL_INT((int)offset, (int)error.offset);
+    TEST_ASSERT_EQUAL_INT(0, (int)error.line);
+    json_error_locate(&error, json, strlen(json));
+    TEST_ASSERT_EQUAL_INT(3, (int)error.line);
+    TEST_ASSERT_EQUAL_INT(7, (int)error.column);
+    TEST_ASSERT_EQUAL_STRING("预期','或']'", json_get_error());
+    TEST_ASSERT(json_get_error() == json_error_message(error.code));
+    TEST_ASSERT_EQUAL_STRING("", json_error_message(JSON_ERROR_NONE));
+
+    // 解析器自身记录错误，并根据自己的输入定位
+    JsonParser* parser = json_parser_create(json);
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_NONE, json_parser_get_error(parser).code);
+    TEST_ASSERT_NULL(json_parse_value(parser));
+    error = json_parser_get_error(parser);
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_EXPECTED_ARRAY_SEPARATOR, error.code);
+    TEST_ASSERT_EQUAL_INT(3, (int)error.line);
+    TEST_ASSERT_EQUAL_INT(7, (int)error.column);
+    json_parser_free(parser);
+
+    // 增量解析：偏移跨块累计，不计算行号
+    parser = json_parser_create_push();
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_NEED_MORE, json_parser_feed(parser, "[1,\n2", 5));
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_ERROR, json_parser_feed(parser, ",x]", 3));
+    error = json_parser_get_error(parser);
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_VALUE, error.code);
+    TEST_ASSERT_EQUAL_INT(6, (int)error.offset);
+    TEST_ASSERT_EQUAL_INT(0, (int)error.line);
+    json_parser_free(parser);
+
+    // 文档模式和按需解析同样记录偏移
+    TEST_ASSERT_NULL(json_parse_into_n(NULL, "[true, nul]", 11));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_NULL, json_get_last_error().code);
+    TEST_ASSERT_EQUAL_INT(7, (int)json_get_last_error().offset);
+    parser = json_parser_create_lazy("{\"a\" 1}", 8, JSON_PARSE_DEFAULT);
+    TEST_ASSERT_NULL(json_cursor_get(json_cursor_root(parser), "a", 1).parser);
+    error = json_parser_get_error(parser);
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_EXPECTED_COLON, error.code);
+    TEST_ASSERT_EQUAL_INT(6, (int)error.column);
+    json_parser_free(parser);
+}
+
+void test_json_parse_array_parallel() {
+    // 约2MB的数组，4个线程时切成多块；字符串中的逗号和括号不能作为切分点
+    size_t count = 30000;
+    size_t cap = count * 80 + 16;
+    char* json = (char*)malloc(cap);
+    TEST_ASSERT_NOT_NULL(json);
+    size_t len = 0;
+    json[len++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        len += sprintf(json + len, "%s{\"id\":%d,\"s\":\"a,[b]\\\"},\",\"t\":[%d,{}]}",
+                       i ? ",\n" : "", (int)i, (int)(i % 7));
+    }
+    json[len++] = ']';
+    json[len] = '\0';
+
+    JsonDocument* doc = json_parse_array_parallel(json, len, JSON_PARSE_INT64, 4);
+    TEST_ASSERT_NOT_NULL(doc);
+    JsonValue* root = json_document_root(doc);
+    TEST_ASSERT_EQUAL_INT(JSON_ARRAY, root->type);
+    TEST_ASSERT_EQUAL_INT((int)count, (int)root->value.array->size);
+    for (size_t i = 0; i < count; i += 997) {
+        JsonValue* id = json_object_get(root->value.array->elements[i]->value.object, "id", 2);
+        TEST_ASSERT_EQUAL_INT((int)i, (int)json_value_get_int64(id));
+    }
+
+    // 结果与顺序解析一致
+    JsonDocument* expected = json_parse_into_ex(NULL, json, len, JSON_PARSE_INT64);
+    char* a = json_value_to_string(json_document_root(expected), 0, NULL);
+    char* b = json_value_to_string(root, 0, NULL);
+    TEST_ASSERT_EQUAL_STRING(a, b);
+    free(a);
+    free(b);
+    json_document_free(expected);
+    json_document_free(doc);
+
+    // 靠后的块出错时报告与顺序解析相同的错误码和偏移
+    char* bad = strstr(json + len - 200, "\"id\"");
+    bad[4] = ' ';
+    TEST_ASSERT_NULL(json_parse_into_n(NULL, json, len));
+    JsonError error = json_get_last_error();
+    TEST_ASSERT_NULL(json_parse_array_parallel(json, len, JSON_PARSE_DEFAULT, 4));
+    TEST_ASSERT_EQUAL_INT(error.code, json_get_last_error().code);
+    TEST_ASSERT_EQUAL_INT((int)error.offset, (int)json_get_last_error().offset);
+    bad[4] = ':';
+
+    // 括号不匹配、多余字符
+    json[len - 1] = '}';
+    TEST_ASSERT_NULL(json_parse_array_parallel(json, len, JSON_PARSE_DEFAULT, 4));
+    json[len - 1] = ']';
+    json[len] = 'x';
+    TEST_ASSERT_NULL(json_parse_array_parallel(json, len + 1, JSON_PARSE_DEFAULT, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_TRAILING_CHARACTERS, json_get_last_error().code);
+    TEST_ASSERT_EQUAL_INT((int)len, (int)json_get_last_error().offset);
+    free(json);
+
+    // 小输入、空数组和非数组根退化为顺序解析
+    doc = json_parse_array_parallel(" [ ] ", 5, JSON_PARSE_DEFAULT, 4);
+    TEST_ASSERT_NOT_NULL(doc);
+    TEST_ASSERT_EQUAL_INT(0, (int)json_document_root(doc)->value.array->size);
+    json_document_free(doc);
+    doc = json_parse_array_parallel("{\"a\":1}", 7, JSON_PARSE_DEFAULT, 0);
+    TEST_ASSERT_NOT_NULL(doc);
+    TEST_ASSERT_EQUAL_INT(JSON_OBJECT, json_document_root(doc)->type);
+    json_document_free(doc);
+    TEST_ASSERT_NULL(json_parse_array_parallel("[1,]", 4, JSON_PARSE_DEFAULT, 4));
+    TEST_ASSERT_NULL(json_parse_array_parallel("[1]", 3, JSON_PARSE_INSITU, 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_FLAGS, json_get_last_error().code);
+}
+
+// 统计内存池中的内存块数
+static size_t count_arena_blocks(const JsonArenaBlock* block) {
+    size_t count = 0;
+    for (; block; block = block->next) count++;
+    return count;
+}
+
+void test_json_document_reuse() {
+    JsonDocument* doc = json_document_create();
+    TEST_ASSERT_NOT_NULL(doc);
+
+    // 依次解析不同的输入，上一次的结果被丢弃
+    JsonValue* root = json_document_parse(doc, "{\"a\":[1,2,3],\"b\":{},\"c\":[]}", 27, JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT(json_document_root(doc) == root);
+    JsonValue* a = json_object_get(root->value.object, "a", 1);
+    TEST_ASSERT_EQUAL_INT(3, (int)a->value.array->size);
+    TEST_ASSERT_EQUAL_INT(3, (int)json_value_get_int64(a->value.array->elements[2]));
+    TEST_ASSERT_EQUAL_INT(0, (int)json_object_get(root->value.object, "b", 1)->value.object->size);
+    TEST_ASSERT_EQUAL_INT(0, (int)json_object_get(root->value.object, "c", 1)->value.array->size);
+
+    root = json_document_parse(doc, "[\"x\", true]", 11, JSON_PARSE_DEFAULT);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_EQUAL_INT(2, (int)root->value.array->size);
+    TEST_ASSERT_EQUAL_STRING("x", json_value_get_string(root->value.array->elements[0]));
+
+    // 失败后文档仍可继续使用
+    TEST_ASSERT_NULL(json_document_parse(doc, "{\"a\":[1,2}", 10, JSON_PARSE_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_EXPECTED_ARRAY_SEPARATOR, json_get_last_error().code);
+    TEST_ASSERT_NULL(json_document_root(doc));
+    char insitu[] = "{\"k\":\"v\\n\"}";
+    root = json_document_parse(doc, insitu, strlen(insitu), JSON_PARSE_INSITU);
+    TEST_ASSERT_NOT_NULL(root);
+    TEST_ASSERT_EQUAL_STRING("v\n", json_value_get_string(json_object_get(root->value.object, "k", 1)));
+
+    // 大输入：重复解析复用全部内存块和结构索引，不再分配新的内存块
+    size_t count = 4000;
+    char* json = (char*)malloc(count * 48 + 16);
+    TEST_ASSERT_NOT_NULL(json);
+    size_t len = 0;
+    json[len++] = '[';
+    for (size_t i = 0; i < count; i++) {
+        len += sprintf(json + len, "%s{\"id\":%d,\"name\":\"item %d\",\"v\":[%d]}", i ? "," : "",
+                       (int)i, (int)i, (int)i);
+    }
+    json[len++] = ']';
+    TEST_ASSERT_NOT_NULL(json_document_parse(doc, json, len, JSON_PARSE_DEFAULT));
+    size_t blocks = count_arena_blocks(doc->arena->head);
+    TEST_ASSERT(blocks > 1);
+    for (int round = 0; round < 3; round++) {
+        root = json_document_parse(doc, json, len, JSON_PARSE_DEFAULT);
+        TEST_ASSERT_NOT_NULL(root);
+        TEST_ASSERT_EQUAL_INT((int)count, (int)root->value.array->size);
+        TEST_ASSERT_EQUAL_INT((int)blocks, (int)count_arena_blocks(doc->arena->head));
+        TEST_ASSERT_NULL(doc->arena->spare);
+    }
+    JsonValue* last = root->value.array->elements[count - 1];
+    TEST_ASSERT_EQUAL_DOUBLE((double)(count - 1), json_value_get_number(json_object_get(last->value.object, "id", 2)), 0.0);
+
+    // 重置后内存块进入空闲链表，小输入只使用一个内存块
+    json_document_reset(doc);
+    TEST_ASSERT_NULL(json_document_root(doc));
+    TEST_ASSERT_EQUAL_INT((int)blocks - 1, (int)count_arena_blocks(doc->arena->spare));
+    TEST_ASSERT_NOT_NULL(json_document_parse(doc, "[1]", 3, JSON_PARSE_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(1, (int)count_arena_blocks(doc->arena->head));
+    free(json);
+
+    TEST_ASSERT_NULL(json_document_parse(doc, "1", 1, 1u << 7));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_FLAGS, json_get_last_error().code);
+    json_document_free(doc);
+}
+
+// 遍历磁带上的每个值，容器的成员再按下标或键查找一次；返回访问的值数
+static size_t tape_visit(JsonTapeRef ref) {
+    size_t visited = 1;
+    JsonTapeIter iter = json_tape_iter(ref);
+    JsonTapeRef value;
+    if (json_tape_type(ref) == JSON_ARRAY) {
+        size_t i = 0;
+        while (json_tape_array_next(&iter, &value)) {
+            if (json_tape_array_get(ref, i++).index != value.index) return 0;
+            visited += tape_visit(value);
+        }
+    } else if (json_tape_type(ref) == JSON_OBJECT) {
+        const char* key;
+        size_t key_length;
+        while (json_tape_object_next(&iter, &key, &key_length, &value)) {
+            if (!json_tape_object_get(ref, key, key_length).tape) return 0;
+            visited += tape_visit(value);
+        }
+    } else {
+        json_tape_get_string(ref, NULL);
+        json_tape_get_number(ref);
+    }
+    return visited;
+}
+
+void test_json_tape_snapshot() {
+    // 20个成员的对象和40个元素的数组会附带查找表，"id"和"name"键在快照中各只保存一次
+    char json[4096];
+    size_t len = (size_t)sprintf(json, "{\"title\":\"ref\",\"big\":[");
+    for (int i = 0; i < 40; i++) {
+        len += (size_t)sprintf(json + len, "%s{\"id\":%d,\"name\":\"n%d\"}", i ? "," : "", i, i);
+    }
+    len += (size_t)sprintf(json + len, "],\"wide\":{");
+    for (int i = 0; i < 20; i++) len += (size_t)sprintf(json + len, "%s\"k%d\":%d", i ? "," : "", i, i * 10);
+    len += (size_t)sprintf(json + len, ",\"k3\":-1},\"x\":[1.5,true,null,18446744073709551615]}");
+
+    JsonDocument* doc = json_parse_into_ex(NULL, json, len, JSON_PARSE_INT64);
+    TEST_ASSERT_NOT_NULL(doc);
+    JsonTape* tape = json_tape_from_value(json_document_root(doc));
+    TEST_ASSERT_NOT_NULL(tape);
+
+    const char* path = "test_tape_snapshot.bin";
+    TEST_ASSERT(json_tape_save(tape, path));
+    size_t size;
+    void* buffer = json_tape_snapshot(tape, &size);
+    TEST_ASSERT_NOT_NULL(buffer);
+
+    JsonTape* loaded = json_tape_load(path);
+    TEST_ASSERT_NOT_NULL(loaded);
+    JsonTapeRef root = json_tape_root(loaded);
+    TEST_ASSERT_EQUAL_INT((int)json_tape_word_count(tape), (int)json_tape_word_count(loaded));
+    size_t title_len;
+    TEST_ASSERT_EQUAL_STRING("ref", json_tape_get_string(json_tape_object_get(root, "title", 5), &title_len));
+    TEST_ASSERT_EQUAL_INT(3, (int)title_len);
+
+    // 查找表：按下标O(1)，按键哈希查找，重复的键返回第一个
+    JsonTapeRef big = json_tape_object_get(root, "big", 3);
+    TEST_ASSERT_EQUAL_INT(40, (int)json_tape_size(big));
+    JsonTapeRef item = json_tape_array_get(big, 37);
+    TEST_ASSERT_EQUAL_INT(37, (int)json_tape_get_int64(json_tape_object_get(item, "id", 2)));
+    TEST_ASSERT_EQUAL_STRING("n37", json_tape_get_string(json_tape_object_get(item, "name", 4), NULL));
+    TEST_ASSERT_NULL(json_tape_array_get(big, 40).tape);
+    JsonTapeRef wide = json_tape_object_get(root, "wide", 4);
+    TEST_ASSERT_EQUAL_INT(21, (int)json_tape_size(wide));
+    TEST_ASSERT_EQUAL_INT(30, (int)json_tape_get_int64(json_tape_object_get(wide, "k3", 2)));
+    TEST_ASSERT_EQUAL_INT(190, (int)json_tape_get_int64(json_tape_object_get(wide, "k19", 3)));
+    TEST_ASSERT_NULL(json_tape_object_get(wide, "k20", 3).tape);
+
+    JsonTapeRef x = json_tape_object_get(root, "x", 1);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, json_tape_get_number(json_tape_array_get(x, 0)), 0.0);
+    TEST_ASSERT(json_tape_get_bool(json_tape_array_get(x, 1)));
+    TEST_ASSERT_EQUAL_INT(JSON_NULL, json_tape_type(json_tape_array_get(x, 2)));
+    TEST_ASSERT(json_tape_get_uint64(json_tape_array_get(x, 3)) == UINT64_MAX);
+
+    // 加载的磁带只读
+    TEST_ASSERT(!json_tape_parse(loaded, "[]", 2, JSON_PARSE_DEFAULT));
+    json_tape_free(loaded);
+
+    // 格式检查：截断、魔数错误、未对齐
+    uint64_t* aligned = (uint64_t*)malloc(size + 8);
+    TEST_ASSERT_NOT_NULL(aligned);
+    memcpy(aligned, buffer, size);
+    loaded = json_tape_load_buffer(aligned, size);
+    TEST_ASSERT_NOT_NULL(loaded);
+    TEST_ASSERT_EQUAL_INT(37, (int)json_tape_get_int64(json_tape_object_get(json_tape_array_get(
+        json_tape_object_get(json_tape_root(loaded), "big", 3), 37), "id", 2)));
+    json_tape_free(loaded);
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size - 4));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+    ((char*)aligned)[0] = 'X';
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    TEST_ASSERT_NULL(json_tape_load_buffer((char*)aligned + 1, size));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_INVALID_ARGUMENT, json_get_last_error().code);
+
+    // 损坏的快照在加载时被拒绝：磁带紧跟48字节的头部，words[0]是根对象，words[1]是键"title"
+    uint64_t* words = aligned + 6;
+    size_t word_count = json_tape_word_count(tape);
+    memcpy(aligned, buffer, size);
+    words[0] += 5;                          // 根的结束位置越过磁带
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+    memcpy(aligned, buffer, size);
+    words[1] |= UINT64_C(0xFFFFFF);         // 字符串偏移越过字符串区
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+    memcpy(aligned, buffer, size);
+    words[word_count - 1] ^= 1;             // 根的结束标记不再指向开始标记
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    memcpy(aligned, buffer, size);
+    ((uint32_t*)((char*)aligned + size))[-1] ^= 1;  // 对象查找表的最后一个槽位
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+
+    // 查找表长度乘4后回绕到真实长度，目录偏移指向真实查找表之外
+    uint64_t header_fields[4];              // 字数、字符串区长度、目录项数、查找表长度
+    memcpy(header_fields, (char*)buffer + 16, sizeof(header_fields));
+    size_t directory_at = 48 + (size_t)header_fields[0] * 8 + (((size_t)header_fields[1] + 7) & ~(size_t)7);
+    TEST_ASSERT(header_fields[2] > 0);
+    memcpy(aligned, buffer, size);
+    uint64_t inflated = header_fields[3] + (UINT64_C(1) << 62);
+    memcpy((char*)aligned + 40, &inflated, sizeof(inflated));
+    uint32_t past_tables = (uint32_t)header_fields[3] + 5;
+    memcpy((char*)aligned + directory_at + sizeof(uint32_t), &past_tables, sizeof(past_tables));
+    TEST_ASSERT_NULL(json_tape_load_buffer(aligned, size));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+
+    // 逐字节翻转：要么拒绝，要么加载后能安全地遍历全部值
+    bool walked = true;
+    for (size_t i = sizeof(uint64_t) * 6; i < size; i++) {
+        memcpy(aligned, buffer, size);
+        ((unsigned char*)aligned)[i] ^= 0xFF;
+        loaded = json_tape_load_buffer(aligned, size);
+        if (loaded && tape_visit(json_tape_root(loaded)) == 0) walked = false;
+        json_tape_free(loaded);
+    }
+    TEST_ASSERT(walked);
+
+    // 损坏的快照文件
+    memcpy(aligned, buffer, size);
+    words[0] += 5;
+    FILE* file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT(fwrite(aligned, 1, size, file) == size);
+    fclose(file);
+    TEST_ASSERT_NULL(json_tape_load(path));
+    TEST_ASSERT_EQUAL_INT(JSON_ERROR_SNAPSHOT_FORMAT, json_get_last_error().code);
+    free(aligned);
+
+    // 键去重：40个对象的"name"键在快照中只出现一次
+    int names = 0;
+    for (size_t i = 0; i + 5 <= size; i++) {
+        if (memcmp((const char*)buffer + i, "name", 5) == 0) names++;
+    }
+    TEST_ASSERT_EQUAL_INT(1, names);
+
+    free(buffer);
+    remove(path);
+    json_tape_free(tape);
+    json_document_free(doc);
+}
+
+// 转发到标准库并统计调用次数的分配器
+static void* test_alloc_malloc(void* ctx, size_t size) {
+    ((size_t*)ctx)[0]++;
+    return malloc(size);
+}
+
+static void* test_alloc_realloc(void* ctx, void* ptr, size_t size) {
+    ((size_t*)ctx)[0]++;
+    return realloc(ptr, size);
+}
+
+static void test_alloc_free(void* ctx, void* ptr) {
+    if (ptr) ((size_t*)ctx)[1]++;
+    free(ptr);
+}
+
+void test_json_allocator() {
+    // 构建器：结构体和缓冲区扩容都经由指定的分配器
+    size_t calls[2] = {0, 0};
+    JsonAllocator custom = {test_alloc_malloc, test_alloc_realloc, test_alloc_free, calls};
+    JsonBuilder* builder = json_builder_create_with(0, &custom);
+    TEST_ASSERT_NOT_NULL(builder);
+    json_builder_start_object(builder);
+    for (int i = 0; i < 100; i++) json_builder_add_int64(builder, "k", i);
+    json_builder_end_object(builder);
+    TEST_ASSERT_EQUAL_INT(1 + 10 * 6 + 90 * 7 - 1 + 1, (int)strlen(json_builder_get_string(builder)));
+    size_t builder_calls = calls[0];
+    TEST_ASSERT(builder_calls > 2);
+    json_builder_free(builder);
+    TEST_ASSERT_EQUAL_INT(2, (int)calls[1]);
+
+    // 计数分配器：解析器和值树，释放后没有未释放的字节
+    JsonAllocStats stats;
+    JsonAllocator counting = json_alloc_stats_init(&stats, &custom);
+    const char* json = "{\"name\":\"x\",\"list\":[1,2,3,{\"a\":null}],\"s\":\"long string value\"}";
+    JsonParser* parser = json_parser_create_with(json, strlen(json), &counting);
+    TEST_ASSERT_NOT_NULL(parser);
+    JsonValue* value = json_parse_value(parser);
+    TEST_ASSERT_NOT_NULL(value);
+    json_parser_free(parser);
+    TEST_ASSERT(stats.allocations > 10);
+    TEST_ASSERT(stats.current > 0);
+    TEST_ASSERT(stats.peak >= stats.current);
+    TEST_ASSERT(stats.bytes >= stats.peak);
+    TEST_ASSERT(calls[0] == builder_calls + stats.allocations);
+    json_value_free_with(value, &counting);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+    TEST_ASSERT(stats.frees > 0);
+
+    // 增量解析器：分块送入时状态、缓冲区和取走的值树都经由指定的分配器
+    json_alloc_stats_reset(&stats);
+    size_t before_push = calls[0];
+    parser = json_parser_create_push_with(&counting);
+    TEST_ASSERT_NOT_NULL(parser);
+    size_t json_len = strlen(json);
+    for (size_t i = 0; i < json_len; i += 5) {
+        size_t n = json_len - i < 5 ? json_len - i : 5;
+        TEST_ASSERT(json_parser_feed(parser, json + i, n) != JSON_FEED_ERROR);
+    }
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_COMPLETE, json_parser_finish(parser));
+    value = json_parser_take_value(parser);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL_STRING("long string value", json_value_get_string(json_object_get(json_value_get_object(value), "s", 1)));
+    json_parser_free(parser);
+    TEST_ASSERT(stats.allocations > 10);
+    TEST_ASSERT(calls[0] == before_push + stats.allocations);
+    TEST_ASSERT(stats.current > 0);
+    json_value_free_with(value, &counting);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+
+    // 未取走的值随解析器一起经由分配器释放
+    json_alloc_stats_reset(&stats);
+    parser = json_parser_create_push_with(&counting);
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_EQUAL_INT(JSON_FEED_NEED_MORE, json_parser_feed(parser, json, json_len / 2));
+    json_parser_free(parser);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+
+    // 可复用文档：每次解析前重置计数，预热后的解析不再分配
+    JsonDocument* doc = json_document_create_with(&counting);
+    TEST_ASSERT_NOT_NULL(doc);
+    json_alloc_stats_reset(&stats);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.allocations);
+    TEST_ASSERT(stats.peak == stats.current);
+    TEST_ASSERT_NOT_NULL(json_document_parse(doc, json, strlen(json), JSON_PARSE_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(2, (int)stats.allocations);   // 第一个内存块和容器暂存栈
+    json_alloc_stats_reset(&stats);
+    TEST_ASSERT_NOT_NULL(json_document_parse(doc, json, strlen(json), JSON_PARSE_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.allocations);
+    json_document_free(doc);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+
+    // 内存池：文档解析的所有分配都落在内存池中
+    JsonArena* arena = json_arena_create_with(256, &counting);
+    TEST_ASSERT_NOT_NULL(arena);
+    TEST_ASSERT_NOT_NULL(json_parse_into(arena, json));
+    TEST_ASSERT(stats.current > 0);
+    json_arena_free(arena);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+
+    // 全局分配器：未指定分配器的接口都经由它
+    json_alloc_stats_reset(&stats);
+    json_set_allocator(&counting);
+    TEST_ASSERT(json_get_allocator()->ctx == &stats);
+    value = json_parse(json);
+    TEST_ASSERT_NOT_NULL(value);
+    char* text = json_value_to_string(value, JSON_SERIALIZE_COMPACT, NULL);
+    TEST_ASSERT_NOT_NULL(text);
+    json_free(NULL, text);
+    json_value_free(value);
+    JsonNdjsonBatch* batch = json_parse_ndjson("{\"a\":1}\n[2]\n", 12, 2);
+    TEST_ASSERT_NOT_NULL(batch);
+    TEST_ASSERT_EQUAL_INT(2, (int)batch->count);
+    json_ndjson_batch_free(batch);
+    size_t global_allocations = stats.allocations;
+    json_set_allocator(NULL);
+    TEST_ASSERT(global_allocations > 10);
+    TEST_ASSERT_EQUAL_INT(0, (int)stats.current);
+    TEST_ASSERT_NULL(json_get_allocator()->ctx);
+
+    // 计数分配器本身也可以作为全局分配器的上层：parent为NULL时复制当前的全局分配器
+    JsonAllocStats outer;
+    JsonAllocator outer_counting = json_alloc_stats_init(&outer, NULL);
+    void* p = json_malloc(&outer_counting, 100);
+    p = json_realloc(&outer_counting, p, 300);
+    TEST_ASSERT_NOT_NULL(p);
+    TEST_ASSERT_EQUAL_INT(2, (int)outer.allocations);
+    TEST_ASSERT_EQUAL_INT(400, (int)outer.bytes);
+    TEST_ASSERT_EQUAL_INT(300, (int)outer.current);
+    TEST_ASSERT_EQUAL_INT(300, (int)outer.peak);
+    p = json_realloc(&outer_counting, p, 50);
+    TEST_ASSERT_EQUAL_INT(50, (int)outer.current);
+    TEST_ASSERT_EQUAL_INT(300, (int)outer.peak);
+    json_free(&outer_counting, p);
+    TEST_ASSERT_EQUAL_INT(0, (int)outer.current);
+    TEST_ASSERT_EQUAL_INT(1, (int)outer.frees);
+    TEST_ASSERT_NULL(json_calloc(&outer_counting, SIZE_MAX / 2, 4));
+}
+
 // 主测试函数
 int main() {
     // 设置控制台为UTF-8编码
@@ -320,6 +1928,32 @@ int main() {
     RUN_TEST(test_json_empty_structures);
     RUN_TEST(test_json_number_limits);
     RUN_TEST(test_json_deep_nesting);
+    RUN_TEST(test_json_document_arena);
+    RUN_TEST(test_json_whitespace_heavy);
+    RUN_TEST(test_json_long_strings);
+    RUN_TEST(test_json_parse_insitu);
+    RUN_TEST(test_json_parse_length_delimited);
+    RUN_TEST(test_json_parse_file);
+    RUN_TEST(test_json_push_parser);
+    RUN_TEST(test_json_parse_events);
+    RUN_TEST(test_json_parse_ndjson);
+    RUN_TEST(test_json_object_get);
+    RUN_TEST(test_json_parse_int64);
+    RUN_TEST(test_json_builder_number_format);
+    RUN_TEST(test_json_builder_length_variants);
+    RUN_TEST(test_json_builder_escape);
+    RUN_TEST(test_json_escape_roundtrip);
+    RUN_TEST(test_json_builder_sink);
+    RUN_TEST(test_json_value_serialize);
+    RUN_TEST(test_json_serialize_roundtrip);
+    RUN_TEST(test_json_tape);
+    RUN_TEST(test_json_cursor);
+    RUN_TEST(test_json_path);
+    RUN_TEST(test_json_error_info);
+    RUN_TEST(test_json_parse_array_parallel);
+    RUN_TEST(test_json_document_reuse);
+    RUN_TEST(test_json_tape_snapshot);
+    RUN_TEST(test_json_allocator);
 
     // 完成测试并显示结果
     unity_end();